@@ -0,0 +1,146 @@
+#include <algorithm>
+#include <stdexcept>
+
+#include "alphabet.h"
+
+Alphabet::Alphabet() :
+    m_letters(1, 0), m_glyphs(1, ".")
+{
+}
+
+Alphabet::Alphabet(std::vector<char32_t> letters) :
+    Alphabet()
+{
+    std::sort(letters.begin(), letters.end());
+    letters.erase(std::unique(letters.begin(), letters.end()), letters.end());
+    if (letters.size() > MAX_SIZE - 1)
+    {
+        throw std::runtime_error("The word list uses " + std::to_string(letters.size())
+                                 + " different letters, but at most " + std::to_string(MAX_SIZE - 1)
+                                 + " are supported");
+    }
+
+    for (char32_t const letter : letters)
+    {
+        m_letters.push_back(letter);
+        append_utf8(letter, m_glyphs.emplace_back());
+    }
+}
+
+char Alphabet::encode(char32_t letter) const
+{
+    auto const it = std::lower_bound(m_letters.begin() + 1, m_letters.end(), letter);
+    if (it == m_letters.end() || *it != letter)
+        return EMPTY;
+    return static_cast<char>(it - m_letters.begin());
+}
+
+char32_t Alphabet::letter(char code) const
+{
+    return m_letters[static_cast<unsigned char>(code)];
+}
+
+std::string_view Alphabet::glyph(char code) const
+{
+    return m_glyphs[static_cast<unsigned char>(code)];
+}
+
+std::size_t Alphabet::size() const
+{
+    return m_letters.size();
+}
+
+char32_t Alphabet::to_upper(char32_t letter)
+{
+    if (letter >= U'a' && letter <= U'z')
+        return letter - 0x20;
+    if (letter < 0xE0)
+        return letter;
+    // Latin-1 Supplement, except for the division sign
+    if (letter <= 0xFE)
+        return letter == 0xF7 ? letter : letter - 0x20;
+    if (letter == 0xFF)
+        return 0x178;
+    // Latin Extended-A: upper and lower case alternate, apart from ı, ĸ and ŉ
+    if ((letter >= 0x100 && letter <= 0x137 && letter != 0x131) || (letter >= 0x14A && letter <= 0x177))
+        return letter & ~char32_t(1);
+    if ((letter >= 0x139 && letter <= 0x148) || (letter >= 0x179 && letter <= 0x17E))
+        return letter % 2 == 0 ? letter - 1 : letter;
+    if (letter == 0x17F) // long s
+        return U'S';
+    return letter;
+}
+
+std::size_t Alphabet::decode_utf8(std::string_view text, char32_t &letter)
+{
+    if (text.empty())
+        return 0;
+
+    auto const lead = static_cast<unsigned char>(text[0]);
+    std::size_t length;
+    if (lead < 0x80)
+    {
+        letter = lead;
+        return 1;
+    }
+    else if (lead >= 0xC2 && lead < 0xE0)
+    {
+        length = 2;
+        letter = lead & 0x1F;
+    }
+    else if (lead >= 0xE0 && lead < 0xF0)
+    {
+        length = 3;
+        letter = lead & 0x0F;
+    }
+    else if (lead >= 0xF0 && lead < 0xF5)
+    {
+        length = 4;
+        letter = lead & 0x07;
+    }
+    else
+    {
+        return 0;
+    }
+
+    if (text.size() < length)
+        return 0;
+    for (std::size_t i = 1; i < length; i++)
+    {
+        auto const continuation = static_cast<unsigned char>(text[i]);
+        if ((continuation & 0xC0) != 0x80)
+            return 0;
+        letter = (letter << 6) | (continuation & 0x3F);
+    }
+    // reject overlong encodings, surrogates and code points past Unicode
+    if ((length == 3 && letter < 0x800) || (length == 4 && (letter < 0x10000 || letter > 0x10FFFF))
+        || (letter >= 0xD800 && letter <= 0xDFFF))
+        return 0;
+    return length;
+}
+
+void Alphabet::append_utf8(char32_t letter, std::string &text)
+{
+    if (letter < 0x80)
+    {
+        text.push_back(static_cast<char>(letter));
+    }
+    else if (letter < 0x800)
+    {
+        text.push_back(static_cast<char>(0xC0 | (letter >> 6)));
+        text.push_back(static_cast<char>(0x80 | (letter & 0x3F)));
+    }
+    else if (letter < 0x10000)
+    {
+        text.push_back(static_cast<char>(0xE0 | (letter >> 12)));
+        text.push_back(static_cast<char>(0x80 | ((letter >> 6) & 0x3F)));
+        text.push_back(static_cast<char>(0x80 | (letter & 0x3F)));
+    }
+    else
+    {
+        text.push_back(static_cast<char>(0xF0 | (letter >> 18)));
+        text.push_back(static_cast<char>(0x80 | ((letter >> 12) & 0x3F)));
+        text.push_back(static_cast<char>(0x80 | ((letter >> 6) & 0x3F)));
+        text.push_back(static_cast<char>(0x80 | (letter & 0x3F)));
+    }
+}
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/**
+    Dense encoding of the letters of a word list. Every distinct (upper case)
+    letter of the list is given a code from 1 to MAX_SIZE - 1, in the order of
+    the letters' Unicode code points. Words and grid cells hold these codes
+    instead of UTF-8 bytes, so a letter like Ä is one cell and per-letter
+    tables have a small fixed size. Code 0 is no letter (an empty cell).
+ */
+class Alphabet
+{
+public:
+    static constexpr std::size_t MAX_SIZE = 64;
+    static constexpr char EMPTY = 0;
+
+private:
+    // letter of every code, m_letters[EMPTY] is unused
+    std::vector<char32_t> m_letters;
+    // UTF-8 glyph of every code
+    std::vector<std::string> m_glyphs;
+
+public:
+    /**
+        Alphabet without any letters.
+     */
+    Alphabet();
+
+    /**
+        Alphabet of the given letters, which may contain duplicates. Throws
+        std::runtime_error if there are more than MAX_SIZE - 1 distinct letters.
+     */
+    explicit Alphabet(std::vector<char32_t> letters);
+
+    /**
+        @return the code of a letter, or EMPTY if it is not in the alphabet
+     */
+    char encode(char32_t letter) const;
+
+    char32_t letter(char code) const;
+
+    /**
+        UTF-8 text of a letter. The glyph of EMPTY is ".".
+     */
+    std::string_view glyph(char code) const;
+
+    /**
+        Number of codes, including EMPTY.
+     */
+    std::size_t size() const;
+
+    /**
+        Upper case of a letter. Covers the Latin-1 Supplement and Latin
+        Extended-A blocks besides ASCII, other letters are returned as is.
+        Letters without a single upper case letter, like ß, are kept.
+     */
+    static char32_t to_upper(char32_t letter);
+
+    /**
+        Decodes the UTF-8 sequence at the start of 'text'.
+        @return the length of the sequence, or 0 if it is not valid UTF-8
+     */
+    static std::size_t decode_utf8(std::string_view text, char32_t &letter);
+
+    static void append_utf8(char32_t letter, std::string &text);
+};
@@ -0,0 +1,201 @@
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <sstream>
+
+#include "annealer.h"
+#include "layoutscorer.h"
+#include "simplescorer.h"
+
+// how often (in iterations) the time budget is checked
+#define DEADLINE_CHECK_INTERVAL 256
+
+using namespace search;
+
+Annealer::Annealer(INIReader const &config) :
+    m_iterations(config.GetInteger("annealing", "iterations", 0)),
+    m_time_budget(config.GetInteger("annealing", "time_budget_ms", 0)),
+    m_start_temperature(config.GetReal("annealing", "start_temperature", 100.0)),
+    m_end_temperature(config.GetReal("annealing", "end_temperature", 1.0))
+{
+    std::ostringstream os;
+
+    os << "Initialized annealer with the following parameters" << std::endl;
+    os << "iterations = " << m_iterations << std::endl;
+    os << "time_budget_ms = " << m_time_budget.count() << std::endl;
+    os << "start_temperature = " << m_start_temperature << std::endl;
+    os << "end_temperature = " << m_end_temperature << std::endl;
+
+    std::cout << os.str();
+}
+
+bool Annealer::is_enabled() const
+{
+    return m_iterations > 0;
+}
+
+std::chrono::milliseconds Annealer::get_time_budget() const
+{
+    return m_time_budget;
+}
+
+void Annealer::get_placements(grid::Grid const &grid, std::vector<Placement> &buffer) const
+{
+    std::vector<grid::Location> locations;
+    grid.get_placed_locations(locations);
+    for (auto const &loc : locations)
+    {
+        buffer.push_back({ *grid.get_word_at(loc), loc });
+    }
+}
+
+template<typename ScorerPolicy>
+scoring::score Annealer::improve(grid::Grid &grid, WordStore const &words, std::size_t word_count,
+                                 ScorerPolicy const &scorer,
+                                 std::default_random_engine &rng,
+                                 std::chrono::steady_clock::time_point deadline) const
+{
+    auto score_of = [word_count, &scorer] (grid::Grid const &g) {
+        return scorer.score_grid(g, std::max<std::int_fast32_t>(static_cast<std::int_fast32_t>(word_count) - g.get_placed_word_count(), 0));
+    };
+
+    scoring::score current_score = score_of(grid);
+    scoring::score best_score = current_score;
+    if (!is_enabled() || grid.get_placed_word_count() == 0)
+        return current_score;
+
+    if (m_time_budget.count() > 0)
+    {
+        deadline = std::min(deadline, std::chrono::steady_clock::now() + m_time_budget);
+    }
+
+    std::vector<Placement> best_state;
+    get_placements(grid, best_state);
+
+    std::vector<bool> placed(words.size(), false);
+    for (auto const &placement : best_state)
+    {
+        placed[placement.word] = true;
+    }
+    std::vector<wid> unplaced;
+    for (wid id = 0; id < words.size(); id++)
+    {
+        if (!placed[id])
+            unplaced.push_back(id);
+    }
+
+    std::uniform_real_distribution<double> unit(0.0, 1.0);
+    auto pick = [&rng] (std::size_t size) {
+        return std::uniform_int_distribution<std::size_t>(0, size - 1)(rng);
+    };
+
+    double const cooling = std::pow(m_end_temperature / m_start_temperature, 1.0 / m_iterations);
+    double temperature = m_start_temperature;
+    auto accept = [&] (scoring::score new_score) {
+        return new_score >= current_score
+               || unit(rng) < std::exp((new_score - current_score) / temperature);
+    };
+
+    std::vector<grid::Location> locations;
+    std::vector<grid::Location> candidates;
+    for (std::int_fast64_t i = 0; i < m_iterations; i++, temperature *= cooling)
+    {
+        if (i % DEADLINE_CHECK_INTERVAL == 0 && std::chrono::steady_clock::now() >= deadline)
+            break;
+
+        bool const may_add = static_cast<std::size_t>(grid.get_placed_word_count()) < word_count;
+        if (may_add && !unplaced.empty() && unit(rng) < 0.5)
+        {
+            // move 1: add an unplaced word
+            std::size_t const idx = pick(unplaced.size());
+            candidates.clear();
+            grid.get_valid_placements(unplaced[idx], candidates);
+            if (candidates.empty())
+                continue;
+
+            grid.place_word_unchecked(unplaced[idx], candidates[pick(candidates.size())]);
+            scoring::score const new_score = score_of(grid);
+            if (accept(new_score))
+            {
+                current_score = new_score;
+                std::swap(unplaced[idx], unplaced.back());
+                unplaced.pop_back();
+            }
+            else
+            {
+                grid.remove_last_word();
+            }
+        }
+        else
+        {
+            // move 2: take a word off the grid and place it, or an unplaced
+            // word, somewhere else. Only words crossing at most one other word
+            // are taken off, as removing them cannot split the grid.
+            locations.clear();
+            grid.get_placed_locations(locations);
+            if (locations.size() < 2)
+                continue;
+            locations.erase(std::remove_if(locations.begin(), locations.end(),
+                                           [&grid] (grid::Location const &loc) {
+                                               return grid.get_word_crossing_count(loc) > 1;
+                                           }), locations.end());
+            if (locations.empty())
+                continue;
+
+            grid::Location const removed_loc = locations[pick(locations.size())];
+            wid const removed = *grid.get_word_at(removed_loc);
+            grid.remove_word(removed_loc);
+
+            // index unplaced.size() stands for the removed word itself
+            std::size_t const idx = pick(unplaced.size() + 1);
+            wid const added = idx < unplaced.size() ? unplaced[idx] : removed;
+            candidates.clear();
+            grid.get_valid_placements(added, candidates);
+            if (candidates.empty())
+            {
+                grid.place_word_unchecked(removed, removed_loc);
+                continue;
+            }
+
+            grid.place_word_unchecked(added, candidates[pick(candidates.size())]);
+            scoring::score const new_score = score_of(grid);
+            if (accept(new_score))
+            {
+                current_score = new_score;
+                if (idx < unplaced.size())
+                    unplaced[idx] = removed;
+            }
+            else
+            {
+                grid.remove_last_word();
+                grid.place_word_unchecked(removed, removed_loc);
+            }
+        }
+
+        if (current_score > best_score)
+        {
+            best_score = current_score;
+            best_state.clear();
+            get_placements(grid, best_state);
+        }
+    }
+
+    if (current_score < best_score)
+    {
+        grid.reset();
+        for (auto const &placement : best_state)
+        {
+            grid.place_word_unchecked(placement.word, placement.loc);
+        }
+    }
+    return best_score;
+}
+
+template scoring::score Annealer::improve(grid::Grid &grid, WordStore const &words, std::size_t word_count,
+                                          scoring::SimpleScorerPolicy const &scorer,
+                                          std::default_random_engine &rng,
+                                          std::chrono::steady_clock::time_point deadline) const;
+template scoring::score Annealer::improve(grid::Grid &grid, WordStore const &words, std::size_t word_count,
+                                          scoring::LayoutScorerPolicy const &scorer,
+                                          std::default_random_engine &rng,
+                                          std::chrono::steady_clock::time_point deadline) const;
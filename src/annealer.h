@@ -0,0 +1,62 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <random>
+
+#include "grid.h"
+#include "scorer.h"
+#include "word.h"
+
+#include "INIReader.h"
+
+namespace search {
+
+/**
+    Local improvement of a finished grid by simulated annealing. A move either
+    adds a word that is not placed yet, or takes a word crossing at most one
+    other word off the grid and places it or an unplaced word somewhere else.
+    Moves are accepted by the Metropolis criterion on the scorer's score, with
+    a temperature falling geometrically from start to end temperature.
+ */
+class Annealer
+{
+private:
+    std::int_fast64_t m_iterations;
+    std::chrono::milliseconds m_time_budget;
+    double m_start_temperature;
+    double m_end_temperature;
+
+    typedef struct Placement
+    {
+        wid word;
+        grid::Location loc;
+    } Placement;
+
+    void get_placements(grid::Grid const &grid, std::vector<Placement> &buffer) const;
+
+public:
+    Annealer(INIReader const &config);
+
+    bool is_enabled() const;
+    std::chrono::milliseconds get_time_budget() const;
+
+    /**
+        Improves 'grid' in place. When this returns, grid holds the best grid
+        seen during annealing, which is never worse than the input grid.
+        @param word_count Number of words the grid is meant to hold, see
+        Engine::get_word_count(). No words are added beyond it.
+        @param deadline Point in time at which annealing stops at the latest,
+        in addition to the configured iteration and time budget.
+        @return the score of the resulting grid
+
+        Instantiated for every scorer policy in annealer.cpp, see scoring::PolicyScorer.
+     */
+    template<typename ScorerPolicy>
+    scoring::score improve(grid::Grid &grid, WordStore const &words, std::size_t word_count,
+                           ScorerPolicy const &scorer,
+                           std::default_random_engine &rng,
+                           std::chrono::steady_clock::time_point deadline) const;
+};
+
+} // namespace search
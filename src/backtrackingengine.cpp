@@ -0,0 +1,150 @@
+#include <algorithm>
+#include <iostream>
+#include <sstream>
+
+#include "backtrackingengine.h"
+#include "layoutscorer.h"
+#include "simplescorer.h"
+
+// how often (in search nodes) the deadline is checked
+#define DEADLINE_CHECK_INTERVAL 256
+
+using namespace search;
+
+template<typename ScorerPolicy>
+BacktrackingEngine<ScorerPolicy>::BacktrackingEngine(INIReader const &config) :
+    m_node_limit(config.GetInteger("generator", "backtracking_node_limit", 10000))
+{
+    std::ostringstream os;
+
+    os << "Initialized backtracking engine with the following parameters" << std::endl;
+    os << "backtracking_node_limit = " << m_node_limit << std::endl;
+
+    std::cout << os.str();
+}
+
+template<typename ScorerPolicy>
+void BacktrackingEngine<ScorerPolicy>::fill_grid(grid::Grid &grid, WordStore const &words,
+                                                 Context<ScorerPolicy> &context) const
+{
+    if (words.empty())
+        return;
+
+    SearchState state = { words, context, {}, 0, {}, {}, 0, 0 };
+    for (wid id = 0; id < words.size(); id++)
+    {
+        state.remaining.push_back(id);
+    }
+    std::shuffle(std::begin(state.remaining), std::end(state.remaining), context.rng);
+    Engine::prefer_first_word_last(state.remaining, context.heuristics);
+
+    // the first word is not part of the search, all later words are placed relative to it
+    std::uniform_int_distribution<int> dist(0, 1); // for generating random vert/horizontal
+    grid.place_first_word(state.remaining.back(),
+                          static_cast<grid::Direction>(dist(context.rng)));
+    state.remaining.pop_back();
+    // words without crossings never fit on a non-empty grid
+    state.remaining.erase(std::remove_if(state.remaining.begin(), state.remaining.end(),
+                                         [&context](wid word) { return !context.crossings.can_cross(word); }),
+                          state.remaining.end());
+    for (wid const word : state.remaining)
+    {
+        state.remaining_letters += words.length(word);
+    }
+
+    search(grid, state);
+
+    // rewind to the first word and replay the best placements found
+    while (grid.get_placed_word_count() > 1)
+    {
+        grid.remove_last_word();
+    }
+    for (auto const &placement : state.best_path)
+    {
+        grid.place_word_unchecked(placement.word, placement.loc);
+    }
+}
+
+template<typename ScorerPolicy>
+void BacktrackingEngine<ScorerPolicy>::record_if_best(grid::Grid const &grid, SearchState &state) const
+{
+    if (state.path.size() > state.best_path.size()
+        || (state.path.size() == state.best_path.size()
+            && grid.get_word_crossing_count() > state.best_crossing_count))
+    {
+        state.best_path = state.path;
+        state.best_crossing_count = grid.get_word_crossing_count();
+    }
+}
+
+template<typename ScorerPolicy>
+bool BacktrackingEngine<ScorerPolicy>::search(grid::Grid &grid, SearchState &state) const
+{
+    record_if_best(grid, state);
+
+    if (state.remaining.empty() || ++state.nodes > m_node_limit)
+        return true;
+    if (state.nodes % DEADLINE_CHECK_INTERVAL == 0
+        && std::chrono::steady_clock::now() >= state.context.deadline)
+        return true;
+    if (this->is_hopeless(grid, state.words.size() - grid.get_placed_word_count(), state.remaining.size(),
+                          state.remaining_letters, state.context))
+    {
+        // pruning the first word's subtree gives up the whole restart
+        state.context.abandoned = state.path.empty();
+        return false;
+    }
+
+    // branch on the most constrained word, i.e. the one with the fewest
+    // valid placements. Words without any placement may still fit later on.
+    std::size_t chosen = state.remaining.size();
+    std::vector<grid::Location> placements;
+    std::vector<grid::Location> buffer;
+    for (std::size_t i = 0; i < state.remaining.size(); i++)
+    {
+        buffer.clear();
+        grid.get_valid_placements(state.remaining[i], buffer);
+        if (!buffer.empty() && (chosen == state.remaining.size() || buffer.size() < placements.size()))
+        {
+            chosen = i;
+            std::swap(placements, buffer);
+        }
+    }
+
+    if (chosen == state.remaining.size())
+        return false; // dead end, no word can be placed anymore
+
+    wid const word = state.remaining[chosen];
+    std::swap(state.remaining[chosen], state.remaining.back());
+    state.remaining.pop_back();
+    state.remaining_letters -= state.words.length(word);
+
+    std::shuffle(std::begin(placements), std::end(placements), state.context.rng);
+    bool done = false;
+    for (auto const &loc : placements)
+    {
+        grid.place_word_unchecked(word, loc);
+        if (!state.context.explored.insert(grid.get_hash()))
+        {
+            // reached before in another order
+            grid.remove_last_word();
+            continue;
+        }
+        state.path.push_back({ word, loc });
+
+        done = search(grid, state);
+
+        state.path.pop_back();
+        grid.remove_last_word();
+        if (done)
+            break;
+    }
+
+    state.remaining.push_back(word);
+    state.remaining_letters += state.words.length(word);
+    std::swap(state.remaining[chosen], state.remaining.back());
+    return done;
+}
+
+template class search::BacktrackingEngine<scoring::SimpleScorerPolicy>;
+template class search::BacktrackingEngine<scoring::LayoutScorerPolicy>;
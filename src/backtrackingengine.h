@@ -0,0 +1,60 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "engine.h"
+
+#include "INIReader.h"
+
+namespace search {
+
+/**
+    Depth-first search over word placements. In every search node, the word
+    with the fewest valid placements is placed at each of its locations in
+    turn, using Grid::remove_last_word() to backtrack. The search ends when
+    all words are placed or the node limit is reached, and the grid is left
+    in the state with the most words placed. Subtrees whose grid cannot get
+    into the result pool are not searched.
+ */
+template<typename ScorerPolicy>
+class BacktrackingEngine : public BasicEngine<ScorerPolicy>
+{
+private:
+    typedef struct Placement
+    {
+        wid word;
+        grid::Location loc;
+    } Placement;
+
+    typedef struct SearchState
+    {
+        WordStore const &words;
+        Context<ScorerPolicy> &context;
+        // words not placed yet that may still be placed, and their total length
+        std::vector<wid> remaining;
+        std::int_fast32_t remaining_letters;
+        std::vector<Placement> path;
+        std::vector<Placement> best_path;
+        std::int_fast32_t best_crossing_count;
+        std::int_fast64_t nodes;
+    } SearchState;
+
+    std::int_fast64_t m_node_limit;
+
+    /**
+        Searches all extensions of the current grid.
+        @return true if the search has to end, because all words are placed or
+        the node limit or deadline is reached.
+     */
+    bool search(grid::Grid &grid, SearchState &state) const;
+
+    void record_if_best(grid::Grid const &grid, SearchState &state) const;
+
+public:
+    BacktrackingEngine(INIReader const &config);
+
+    void fill_grid(grid::Grid &grid, WordStore const &words, Context<ScorerPolicy> &context) const override;
+};
+
+} // namespace search
@@ -0,0 +1,209 @@
+#include <algorithm>
+#include <iostream>
+#include <sstream>
+
+#include "beamengine.h"
+#include "layoutscorer.h"
+#include "simplescorer.h"
+
+using namespace search;
+
+template<typename ScorerPolicy>
+BeamEngine<ScorerPolicy>::BeamEngine(INIReader const &config) :
+    m_beam_width(std::max(config.GetInteger("generator", "beam_width", 4), 1L)),
+    m_expansions(std::max(config.GetInteger("generator", "beam_expansions", 8), 1L))
+{
+    std::ostringstream os;
+
+    os << "Initialized beam search engine with the following parameters" << std::endl;
+    os << "beam_width = " << m_beam_width << std::endl;
+    os << "beam_expansions = " << m_expansions << std::endl;
+
+    std::cout << os.str();
+}
+
+template<typename Candidate>
+static bool higher_score(Candidate const &lhs, Candidate const &rhs)
+{
+    return lhs.grid_score > rhs.grid_score;
+}
+
+template<typename ScorerPolicy>
+std::size_t BeamEngine<ScorerPolicy>::expand(Beam &beam, std::size_t beam_idx, WordStore const &words,
+                                             Context<ScorerPolicy> &context,
+                                             std::vector<Candidate> &candidates) const
+{
+    std::size_t hopeless = 0;
+    std::vector<Candidate> expansions;
+    std::vector<grid::Location> placements;
+    for (wid w = 0; w < words.size(); w++)
+    {
+        // words without crossings never fit on a non-empty grid
+        if (beam.placed[w] || !context.crossings.can_cross(w))
+            continue;
+
+        placements.clear();
+        beam.grid->get_valid_placements(w, placements);
+        for (auto const &loc : placements)
+        {
+            beam.grid->place_word_unchecked(w, loc);
+            std::uint64_t const hash = beam.grid->get_hash();
+            std::int_fast32_t unplaced_words = words.size() - beam.grid->get_placed_word_count();
+            if (this->is_hopeless(*beam.grid, unplaced_words, beam.placeable_words - 1,
+                                  beam.placeable_letters - words.length(w), context))
+            {
+                hopeless++;
+            }
+            else if (context.explored.find(hash) == nullptr)
+            {
+                expansions.push_back({ beam_idx, w, loc,
+                                       context.scorer.score_grid(*beam.grid, unplaced_words), hash });
+            }
+            beam.grid->remove_last_word();
+        }
+    }
+
+    // shuffle first, so that ties are broken randomly
+    std::shuffle(expansions.begin(), expansions.end(), context.rng);
+    std::size_t const keep = std::min(m_expansions, expansions.size());
+    std::partial_sort(expansions.begin(), expansions.begin() + keep, expansions.end(),
+                      higher_score<Candidate>);
+    candidates.insert(candidates.end(), expansions.begin(), expansions.begin() + keep);
+    return hopeless;
+}
+
+template<typename ScorerPolicy>
+void BeamEngine<ScorerPolicy>::fill_grid(grid::Grid &grid, WordStore const &words,
+                                         Context<ScorerPolicy> &context) const
+{
+    if (words.empty())
+        return;
+
+    std::vector<wid> first_words(words.size());
+    for (wid i = 0; i < words.size(); i++)
+    {
+        first_words[i] = i;
+    }
+    std::shuffle(first_words.begin(), first_words.end(), context.rng);
+    // Candidates for the first word go first, then the other words crossing
+    // any word. A first word without crossings leaves its beam at one word.
+    std::stable_partition(first_words.begin(), first_words.end(),
+                          [&context](wid word) { return context.crossings.can_cross(word); });
+    std::stable_partition(first_words.begin(), first_words.end(),
+                          [&context](wid word) { return context.heuristics.is_first_word_candidate(word); });
+
+    std::int_fast32_t placeable_words = 0;
+    std::int_fast32_t placeable_letters = 0;
+    for (wid w = 0; w < words.size(); w++)
+    {
+        if (context.crossings.can_cross(w))
+        {
+            placeable_words++;
+            placeable_letters += words.length(w);
+        }
+    }
+
+    // The beam grids are the worker's spare grids, so they are only
+    // allocated in the worker's first restart.
+    auto const take_grid = [&]() {
+        if (context.spare_grids.empty())
+            return std::make_unique<grid::Grid>(words, grid.get_max_height(), grid.get_max_width());
+        std::unique_ptr<grid::Grid> spare = std::move(context.spare_grids.back());
+        context.spare_grids.pop_back();
+        spare->reset();
+        return spare;
+    };
+
+    // the initial beam holds grids with different first words
+    std::uniform_int_distribution<int> dist(0, 1); // for generating random vert/horizontal
+    std::vector<Beam> beams;
+    std::vector<Beam> next_beams;
+    for (std::size_t b = 0; b < std::min(m_beam_width, words.size()); b++)
+    {
+        Beam beam = { take_grid(), std::vector<bool>(words.size(), false), placeable_words, placeable_letters };
+        if (context.crossings.can_cross(first_words[b]))
+        {
+            beam.placeable_words--;
+            beam.placeable_letters -= words.length(first_words[b]);
+        }
+        beam.grid->place_first_word(first_words[b],
+                                    static_cast<grid::Direction>(dist(context.rng)));
+        beam.placed[first_words[b]] = true;
+        beams.push_back(std::move(beam));
+    }
+
+    grid.assign(*beams.front().grid);
+    scoring::score best_score = context.scorer.score_grid(grid, words.size() - 1);
+
+    std::vector<Candidate> candidates;
+    while (std::chrono::steady_clock::now() < context.deadline)
+    {
+        candidates.clear();
+        std::size_t hopeless = 0;
+        for (std::size_t b = 0; b < beams.size(); b++)
+        {
+            hopeless += expand(beams[b], b, words, context, candidates);
+        }
+        if (candidates.empty())
+        {
+            context.abandoned = hopeless > 0;
+            break;
+        }
+
+        // Expansions of different beams may end up as the same grid, e.g. by
+        // placing the same two words in different order. Keep only the first.
+        std::stable_sort(candidates.begin(), candidates.end(), higher_score<Candidate>);
+        std::size_t keep = 0;
+        for (std::size_t c = 0; c < candidates.size() && keep < m_beam_width; c++)
+        {
+            if (context.explored.insert(candidates[c].hash))
+            {
+                candidates[keep++] = candidates[c];
+            }
+        }
+        if (keep == 0)
+            break;
+
+        // Build the next beam from the best candidates. Grids of the last
+        // step are recycled.
+        for (std::size_t c = 0; c < keep; c++)
+        {
+            Candidate const &candidate = candidates[c];
+            Beam const &parent = beams[candidate.beam_idx];
+            if (next_beams.size() <= c)
+            {
+                next_beams.push_back({ take_grid(), {}, 0, 0 });
+            }
+            Beam &child = next_beams[c];
+            child.grid->assign(*parent.grid);
+            child.grid->place_word_unchecked(candidate.word, candidate.loc);
+            child.placed = parent.placed;
+            child.placed[candidate.word] = true;
+            child.placeable_words = parent.placeable_words - 1;
+            child.placeable_letters = parent.placeable_letters - words.length(candidate.word);
+        }
+        for (std::size_t c = keep; c < next_beams.size(); c++)
+        {
+            context.spare_grids.push_back(std::move(next_beams[c].grid));
+        }
+        next_beams.resize(keep);
+        std::swap(beams, next_beams);
+
+        if (candidates.front().grid_score > best_score)
+        {
+            best_score = candidates.front().grid_score;
+            grid.assign(*beams.front().grid);
+        }
+    }
+
+    for (auto *step : { &beams, &next_beams })
+    {
+        for (Beam &beam : *step)
+        {
+            context.spare_grids.push_back(std::move(beam.grid));
+        }
+    }
+}
+
+template class search::BeamEngine<scoring::SimpleScorerPolicy>;
+template class search::BeamEngine<scoring::LayoutScorerPolicy>;
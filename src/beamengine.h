@@ -0,0 +1,63 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "engine.h"
+
+#include "INIReader.h"
+
+namespace search {
+
+/**
+    Beam search over partial grids. Starting from beam_width grids with
+    different first words, every step expands each partial grid with its
+    beam_expansions best scoring placements and keeps the beam_width best of
+    all expansions. The search ends when no partial grid can be extended, and
+    the best partial grid seen is the result. Partial grids that were
+    already in a beam or that cannot get into the result pool are not kept.
+ */
+template<typename ScorerPolicy>
+class BeamEngine : public BasicEngine<ScorerPolicy>
+{
+public:
+    typedef struct Candidate
+    {
+        std::size_t beam_idx;
+        wid word;
+        grid::Location loc;
+        scoring::score grid_score;
+        // hash of the expanded grid
+        std::uint64_t hash;
+    } Candidate;
+
+private:
+    typedef struct Beam
+    {
+        std::unique_ptr<grid::Grid> grid;
+        // placed[id] is true if the word with this id is on grid
+        std::vector<bool> placed;
+        // words that can cross another word and are not on grid, and their total length
+        std::int_fast32_t placeable_words;
+        std::int_fast32_t placeable_letters;
+    } Beam;
+
+    std::size_t m_beam_width;
+    std::size_t m_expansions;
+
+    /**
+        Appends the best expansions of a beam to candidates. Expansions that
+        cannot get into the result pool are dropped.
+        @return the number of dropped expansions
+     */
+    std::size_t expand(Beam &beam, std::size_t beam_idx, WordStore const &words, Context<ScorerPolicy> &context,
+                       std::vector<Candidate> &candidates) const;
+
+public:
+    BeamEngine(INIReader const &config);
+
+    void fill_grid(grid::Grid &grid, WordStore const &words, Context<ScorerPolicy> &context) const override;
+};
+
+} // namespace search
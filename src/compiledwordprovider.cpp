@@ -0,0 +1,293 @@
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+#include <vector>
+
+#include "compiledwordprovider.h"
+#include "csvwordprovider.h"
+#include "mappedfile.h"
+
+using namespace std;
+
+namespace
+{
+
+// On-disk layout of a compiled word list: the header, followed by the
+// sections, each of which starts at a multiple of SECTION_ALIGNMENT. All
+// fields have fixed widths and native byte order.
+
+constexpr char MAGIC[8] = { 'C', 'W', 'W', 'O', 'R', 'D', 'S', '\0' };
+constexpr uint32_t VERSION = 2;
+constexpr size_t SECTION_ALIGNMENT = 8;
+
+enum SectionType
+{
+    LETTERS,
+    CLUES,
+    LETTER_OFFSETS,
+    LENGTHS,
+    CLUE_OFFSETS,
+    LENGTH_OFFSETS,
+    BY_LENGTH,
+    LETTER_COUNTS,
+    // the letter (code point) of every alphabet code, 0 for unused codes
+    ALPHABET,
+    SECTION_COUNT
+};
+
+typedef struct Section
+{
+    uint64_t offset;
+    uint64_t size;
+} Section;
+
+typedef struct FileHeader
+{
+    char magic[8];
+    uint32_t version;
+    uint32_t letter_padding;
+    // FNV-1a hash of the CSV file the word list was compiled from
+    uint64_t source_checksum;
+    uint64_t word_count;
+    uint32_t max_length;
+    uint32_t reserved;
+    Section sections[SECTION_COUNT];
+} FileHeader;
+
+static_assert(sizeof(Section) == 16 && sizeof(FileHeader) == 40 + 16 * SECTION_COUNT,
+              "compiled word list layout must not depend on the compiler");
+
+uint64_t checksum(char const *data, size_t size)
+{
+    uint64_t hash = 0xCBF29CE484222325;
+    for (size_t i = 0; i < size; i++)
+    {
+        hash = (hash ^ static_cast<unsigned char>(data[i])) * 0x100000001B3;
+    }
+    return hash;
+}
+
+string to_hex(uint64_t value)
+{
+    ostringstream out;
+    out << hex << setw(16) << setfill('0') << value;
+    return out.str();
+}
+
+} // namespace
+
+CompiledWordProvider::CompiledWordProvider(const string& location, const string& source_location, bool verify) :
+    m_location(location), m_source_location(source_location), m_verify(verify)
+{
+    std::cout << "Initialized compiled word list provider. "
+      << "Location: " << location << std::endl;
+}
+
+void CompiledWordProvider::retrieve_word_list(WordStore& words) const
+{
+    try
+    {
+        attach_word_list(words);
+    }
+    catch (runtime_error const &error)
+    {
+        if (m_source_location.empty())
+            throw;
+        std::cerr << "Warning: " << error.what() << "\nReading the words from "
+                  << m_source_location << " instead." << std::endl;
+        CSVWordProvider(m_source_location).retrieve_word_list(words);
+    }
+}
+
+void CompiledWordProvider::attach_word_list(WordStore& words) const
+{
+    auto const file = make_shared<MappedFile>(m_location);
+    if (!file->is_open())
+    {
+        throw runtime_error(
+                  "Could not open the compiled word list! Does it exist?\n"
+                  "(Filename: " + m_location + ")"
+                  );
+    }
+
+    auto fail = [this](string const &reason) {
+        return runtime_error("Invalid compiled word list " + m_location + ": " + reason);
+    };
+
+    FileHeader header;
+    if (file->size() < sizeof(header))
+        throw fail("file too short");
+    memcpy(&header, file->data(), sizeof(header));
+    if (memcmp(header.magic, MAGIC, sizeof(MAGIC)) != 0 || header.version != VERSION)
+        throw fail("not a compiled word list of this version, compile it again");
+    if (header.letter_padding != WordStore::LETTER_PADDING)
+        throw fail("compiled with another letter padding, compile it again");
+    if (header.max_length > UINT16_MAX)
+        throw fail("header is damaged");
+    if (m_verify && !m_source_location.empty())
+    {
+        MappedFile const csv_file(m_source_location);
+        if (!csv_file.is_open())
+            throw runtime_error("Could not open the CSV file " + m_source_location);
+        if (checksum(csv_file.data(), csv_file.size()) != header.source_checksum)
+            throw fail("compiled from another version of " + m_source_location + ", compile it again");
+    }
+
+    // expected size of every section, except for the letters and clues
+    uint64_t const count = header.word_count;
+    uint64_t const sizes[SECTION_COUNT] = {
+        0, 0, count * sizeof(uint32_t), count * sizeof(uint16_t), (count + 1) * sizeof(uint32_t),
+        (header.max_length + 2) * sizeof(uint32_t), count * sizeof(wid),
+        WordStore::LETTER_COUNT_SIZE * sizeof(uint32_t), Alphabet::MAX_SIZE * sizeof(uint32_t)
+    };
+    for (int s = 0; s < SECTION_COUNT; s++)
+    {
+        Section const &section = header.sections[s];
+        if (section.offset % SECTION_ALIGNMENT != 0 || section.offset > file->size()
+            || section.size > file->size() - section.offset || (sizes[s] != 0 && section.size != sizes[s]))
+            throw fail("section " + to_string(s) + " is damaged");
+    }
+    if (header.sections[LETTERS].size < WordStore::LETTER_PADDING)
+        throw fail("letters are not padded");
+
+    auto section = [&](SectionType type) {
+        return static_cast<void const *>(file->data() + header.sections[type].offset);
+    };
+    WordStore::Tables tables;
+    tables.size = count;
+    tables.max_length = header.max_length;
+    tables.letters = static_cast<char const *>(section(LETTERS));
+    tables.clues = static_cast<char const *>(section(CLUES));
+    tables.letter_offsets = static_cast<uint32_t const *>(section(LETTER_OFFSETS));
+    tables.lengths = static_cast<uint16_t const *>(section(LENGTHS));
+    tables.clue_offsets = static_cast<uint32_t const *>(section(CLUE_OFFSETS));
+    tables.length_offsets = static_cast<uint32_t const *>(section(LENGTH_OFFSETS));
+    tables.by_length = static_cast<wid const *>(section(BY_LENGTH));
+    tables.letter_counts = static_cast<uint32_t const *>(section(LETTER_COUNTS));
+
+    uint32_t const *alphabet = static_cast<uint32_t const *>(section(ALPHABET));
+    vector<char32_t> letters;
+    for (size_t code = 1; code < Alphabet::MAX_SIZE && alphabet[code] != 0; code++)
+    {
+        letters.push_back(alphabet[code]);
+    }
+
+    // The word store reads the mapped file as is. By default only the header,
+    // the sections and the ends of the offset tables are checked, which takes
+    // the same time whatever the size of the word list; when verifying, every
+    // word and the length table are checked against their sections as well.
+    uint64_t const letter_size = header.sections[LETTERS].size - WordStore::LETTER_PADDING;
+    for (size_t i = 0; i < WordStore::LETTER_PADDING; i++)
+    {
+        if (tables.letters[letter_size + i] != 0)
+            throw fail("letters are not padded");
+    }
+    if (tables.clue_offsets[count] > header.sections[CLUES].size || tables.length_offsets[0] != 0
+        || tables.length_offsets[header.max_length + 1] != count)
+        throw fail("offsets are damaged");
+    if (m_verify)
+    {
+        for (uint64_t i = 0; i < count; i++)
+        {
+            uint64_t const length = tables.lengths[i];
+            if (length == 0 || length > header.max_length || length > letter_size
+                || tables.letter_offsets[i] > letter_size - length
+                || tables.clue_offsets[i] > tables.clue_offsets[i + 1])
+                throw fail("word " + to_string(i) + " is damaged");
+            for (uint64_t l = 0; l < length; l++)
+            {
+                auto const code = static_cast<unsigned char>(tables.letters[tables.letter_offsets[i] + l]);
+                if (code == 0 || code > letters.size())
+                    throw fail("letters of word " + to_string(i) + " are not in the alphabet");
+            }
+        }
+        for (uint64_t length = 0; length <= header.max_length; length++)
+        {
+            if (tables.length_offsets[length] > tables.length_offsets[length + 1])
+                throw fail("length table is damaged");
+            for (uint64_t i = tables.length_offsets[length]; i < tables.length_offsets[length + 1]; i++)
+            {
+                if (tables.by_length[i] >= count || tables.lengths[tables.by_length[i]] != length)
+                    throw fail("length table is damaged");
+            }
+        }
+    }
+
+    words.attach(tables, file);
+    words.set_alphabet(Alphabet(std::move(letters)));
+    std::cout << "Compiled word list holds " << count << " words and was compiled from a CSV file "
+              << "with checksum " << to_hex(header.source_checksum) << std::endl;
+}
+
+void CompiledWordProvider::compile(const string& csv_location, const string& location)
+{
+    uint64_t source_checksum;
+    {
+        MappedFile const csv_file(csv_location);
+        if (!csv_file.is_open())
+            throw runtime_error("Could not open the CSV file " + csv_location);
+        source_checksum = checksum(csv_file.data(), csv_file.size());
+    }
+
+    WordStore words;
+    CSVWordProvider(csv_location).retrieve_word_list(words);
+    WordStore::Tables const &tables = words.tables();
+    size_t const letter_size = tables.size > 0
+                               ? tables.letter_offsets[tables.size - 1] + tables.lengths[tables.size - 1]
+                               : 0;
+
+    FileHeader header = {};
+    memcpy(header.magic, MAGIC, sizeof(MAGIC));
+    header.version = VERSION;
+    header.letter_padding = WordStore::LETTER_PADDING;
+    header.source_checksum = source_checksum;
+    header.word_count = tables.size;
+    header.max_length = tables.max_length;
+
+    uint32_t alphabet[Alphabet::MAX_SIZE] = {};
+    for (size_t code = 1; code < words.alphabet().size(); code++)
+    {
+        alphabet[code] = words.alphabet().letter(code);
+    }
+
+    pair<void const *, size_t> const contents[SECTION_COUNT] = {
+        { tables.letters, letter_size + WordStore::LETTER_PADDING },
+        { tables.clues, tables.clue_offsets[tables.size] },
+        { tables.letter_offsets, tables.size * sizeof(uint32_t) },
+        { tables.lengths, tables.size * sizeof(uint16_t) },
+        { tables.clue_offsets, (tables.size + 1) * sizeof(uint32_t) },
+        { tables.length_offsets, (tables.max_length + 2) * sizeof(uint32_t) },
+        { tables.by_length, tables.size * sizeof(wid) },
+        { tables.letter_counts, WordStore::LETTER_COUNT_SIZE * sizeof(uint32_t) },
+        { alphabet, sizeof(alphabet) }
+    };
+    auto aligned = [](uint64_t offset) {
+        return (offset + SECTION_ALIGNMENT - 1) / SECTION_ALIGNMENT * SECTION_ALIGNMENT;
+    };
+    uint64_t offset = aligned(sizeof(header));
+    for (int s = 0; s < SECTION_COUNT; s++)
+    {
+        header.sections[s] = { offset, contents[s].second };
+        offset = aligned(offset + contents[s].second);
+    }
+
+    ofstream file(location, ios::binary | ios::trunc);
+    if (!file.is_open())
+        throw runtime_error("Could not open the compiled word list " + location + " for writing");
+    char const padding[SECTION_ALIGNMENT] = {};
+    file.write(reinterpret_cast<char const *>(&header), sizeof(header));
+    for (int s = 0; s < SECTION_COUNT; s++)
+    {
+        file.write(padding, header.sections[s].offset - static_cast<uint64_t>(file.tellp()));
+        file.write(static_cast<char const *>(contents[s].first), contents[s].second);
+    }
+    file.close();
+    if (!file)
+        throw runtime_error("Could not write the compiled word list " + location);
+
+    std::cout << "Compiled " << tables.size << " words to " << location << std::endl;
+}
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+#include "word.h"
+#include "wordprovider.h"
+
+/**
+    Provides the words of a compiled word list, a binary file that holds the
+    arrays of a WordStore including its length tables and alphabet. The file is mapped
+    into memory and used as is, so loading it takes the same time whatever
+    the size of the word list, unless the provider is asked to verify every
+    word and the checksum of the CSV file.
+ */
+class CompiledWordProvider : public WordProvider
+{
+private:
+    std::string m_location;
+    std::string m_source_location;
+    bool m_verify;
+
+    /**
+       Maps the compiled word list into memory, checks its header and sections
+       and, when verifying, its words and the CSV file it was compiled from if
+       there is one, and attaches the word store to it. Throws
+       std::runtime_error before the word store is touched if the file cannot
+       be read, is damaged or does not match the CSV file.
+     */
+    void attach_word_list(WordStore& words) const;
+
+public:
+    /**
+       Constructs a new word provider that reads a compiled word list.
+       @param location The compiled word list file name.
+       @param source_location The CSV file the word list was compiled from,
+       or an empty string if there is none.
+       @param verify Whether every word is checked, and the word list checked
+       against the CSV file, when loading. Without it, loading takes the same
+       time whatever the size of the word list, but a damaged word is only
+       noticed if the header or the sections are damaged too.
+     */
+    CompiledWordProvider(const std::string& location, const std::string& source_location = "",
+                         bool verify = false);
+
+    /**
+       Maps the compiled word list into memory and attaches the word store
+       to it. The word store must be empty. If the file is damaged, is not a
+       compiled word list of this version or, when verifying, was compiled from
+       another version of the CSV file, the words are read from the CSV file instead. Throws
+       std::runtime_error if that is not possible because there is no CSV file.
+       @param words The word store that is attached to the word list.
+     */
+    void retrieve_word_list(WordStore& words) const override;
+
+    /**
+       Reads the words of a CSV file (see CSVWordProvider) and writes them
+       to a compiled word list together with a checksum of the CSV file.
+       Throws std::runtime_error if a file cannot be read or written.
+     */
+    static void compile(const std::string& csv_location, const std::string& location);
+};
@@ -0,0 +1,82 @@
+#include <algorithm>
+#include <array>
+
+#include "crossingindex.h"
+
+CrossingIndex::CrossingIndex(WordStore const &words)
+{
+    // where each letter occurs, so that only matching letters are paired up
+    std::array<std::vector<std::pair<wid, std::uint16_t>>, Alphabet::MAX_SIZE> occurrences;
+    for (wid id = 0; id < words.size(); id++)
+    {
+        std::string_view const letters = words.letters(id);
+        for (std::size_t i = 0; i < letters.size(); i++)
+        {
+            occurrences[static_cast<unsigned char>(letters[i])].push_back({ id, i });
+        }
+    }
+
+    m_offsets.reserve(words.size() + 1);
+    m_word_offsets.reserve(words.size() + 1);
+    for (wid id = 0; id < words.size(); id++)
+    {
+        std::string_view const letters = words.letters(id);
+        auto const first = m_crossings.size();
+        for (std::size_t i = 0; i < letters.size(); i++)
+        {
+            for (auto const &[other, other_position] : occurrences[static_cast<unsigned char>(letters[i])])
+            {
+                if (other != id)
+                    m_crossings.push_back({ other, static_cast<std::uint16_t>(i), other_position });
+            }
+        }
+        std::sort(m_crossings.begin() + first, m_crossings.end(), [](Crossing const &lhs, Crossing const &rhs) {
+            return lhs.word < rhs.word || (lhs.word == rhs.word && lhs.position < rhs.position);
+        });
+        m_offsets.push_back(m_crossings.size());
+        for (auto c = first; c < m_crossings.size(); c++)
+        {
+            if (c == first || m_crossings[c].word != m_crossings[c - 1].word)
+                m_words.push_back(m_crossings[c].word);
+        }
+        m_word_offsets.push_back(m_words.size());
+        m_uncrossable_count += m_crossings.size() == first;
+    }
+    m_crossings.shrink_to_fit();
+    m_words.shrink_to_fit();
+}
+
+CrossingIndex::Range<Crossing> CrossingIndex::crossings(wid word) const
+{
+    return { m_crossings.data() + m_offsets[word], m_crossings.data() + m_offsets[word + 1] };
+}
+
+CrossingIndex::Range<Crossing> CrossingIndex::crossings(wid word, wid other) const
+{
+    Range<Crossing> const all = crossings(word);
+    auto const range = std::equal_range(all.begin(), all.end(), Crossing{ other, 0, 0 },
+                                        [](Crossing const &lhs, Crossing const &rhs) {
+                                            return lhs.word < rhs.word;
+                                        });
+    return { range.first, range.second };
+}
+
+CrossingIndex::Range<wid> CrossingIndex::crossing_words(wid word) const
+{
+    return { m_words.data() + m_word_offsets[word], m_words.data() + m_word_offsets[word + 1] };
+}
+
+bool CrossingIndex::can_cross(wid word) const
+{
+    return m_offsets[word + 1] != m_offsets[word];
+}
+
+std::size_t CrossingIndex::size() const
+{
+    return m_crossings.size();
+}
+
+std::size_t CrossingIndex::get_uncrossable_count() const
+{
+    return m_uncrossable_count;
+}
@@ -0,0 +1,75 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "word.h"
+
+/**
+    Letters two words have in common, i.e. where a word can cross another one.
+ */
+typedef struct Crossing
+{
+    // the other word
+    wid word;
+    // position of the shared letter in the word and in the other word
+    std::uint16_t position;
+    std::uint16_t other_position;
+} Crossing;
+
+/**
+    For every word of a WordStore, all crossings with the other words of the
+    store. Built once after the words are loaded and only read afterwards, so
+    all workers share it. The crossings are kept in one array (CSR layout),
+    the crossings of each word sorted by the other word.
+ */
+class CrossingIndex
+{
+private:
+    // crossings of word w are [m_offsets[w], m_offsets[w + 1]) of m_crossings
+    std::vector<std::size_t> m_offsets = { 0 };
+    std::vector<Crossing> m_crossings;
+    // the distinct words crossing word w are [m_word_offsets[w], m_word_offsets[w + 1]) of m_words
+    std::vector<std::size_t> m_word_offsets = { 0 };
+    std::vector<wid> m_words;
+    std::size_t m_uncrossable_count = 0;
+
+public:
+    template<typename T>
+    struct Range
+    {
+        T const *first;
+        T const *last;
+
+        T const * begin() const { return first; }
+        T const * end() const { return last; }
+        bool empty() const { return first == last; }
+    };
+
+    CrossingIndex() = default;
+    CrossingIndex(WordStore const &words);
+
+    /**
+        @return all crossings of the word with other words
+     */
+    Range<Crossing> crossings(wid word) const;
+
+    /**
+        @return the crossings of the word with one other word
+     */
+    Range<Crossing> crossings(wid word, wid other) const;
+
+    /**
+        @return the other words the word can cross, in ascending order
+     */
+    Range<wid> crossing_words(wid word) const;
+
+    /**
+        Checks if the word shares a letter with any other word. Words that do
+        not can only ever be placed as the first word of a grid.
+     */
+    bool can_cross(wid word) const;
+
+    std::size_t size() const;
+    std::size_t get_uncrossable_count() const;
+};
@@ -1,15 +1,148 @@
 #include <algorithm>
+#include <array>
+#include <bitset>
 #include <cstdint>
 #include <iostream>
 #include <string>
-#include <fstream>
-#include <sstream>
+#include <string_view>
 #include <stdexcept>
+#include <thread>
+#include <vector>
 
 #include "csvwordprovider.h"
+#include "mappedfile.h"
 
 using namespace std;
 
+namespace
+{
+
+// smallest part of the file worth parsing on its own thread
+constexpr size_t MIN_CHUNK_SIZE = 1 << 20;
+
+// letters below this are marked as seen in a bitset, the others in a list
+constexpr char32_t SMALL_LETTER_LIMIT = 0x800;
+
+/**
+    Words parsed from one chunk of lines of the CSV file. The clues point into
+    the mapped file, the upper-cased letters of the words are kept back to
+    back in 'letters' and, once the alphabet is known, in 'codes'.
+ */
+typedef struct ParsedChunk
+{
+    vector<string_view> clues;
+    // in letters
+    vector<uint32_t> lengths;
+    vector<char32_t> letters;
+    string codes;
+    size_t clue_size = 0;
+    // the distinct letters of the chunk
+    vector<char32_t> alphabet;
+
+    // number of lines parsed, the last one being the malformed one if 'error' is set
+    size_t line_count = 0;
+    string error;
+    string_view offending_line;
+} ParsedChunk;
+
+void parse_chunk(string_view chunk, char delim, ParsedChunk &parsed)
+{
+    bitset<SMALL_LETTER_LIMIT> seen;
+    parsed.letters.reserve(chunk.size() / 2);
+    size_t pos = 0;
+    while (pos < chunk.size())
+    {
+        size_t end = chunk.find('\n', pos);
+        if (end == string_view::npos)
+        {
+            end = chunk.size();
+        }
+        string_view const line = chunk.substr(pos, end - pos);
+        pos = end + 1;
+        parsed.line_count++;
+
+        // first column is the clue, second one the word
+        string_view clue = line;
+        string_view word;
+        bool more_columns = false;
+        size_t const clue_end = line.find(delim);
+        if (clue_end != string_view::npos)
+        {
+            clue = line.substr(0, clue_end);
+            word = line.substr(clue_end + 1);
+            size_t const word_end = word.find(delim);
+            more_columns = word_end != string_view::npos;
+            word = word.substr(0, word_end);
+        }
+        clue = WordProvider::trim(clue);
+        word = WordProvider::trim(word);
+
+        if (clue.empty() || word.empty())
+        {
+            parsed.error = "Clue or solution word is empty \n";
+            parsed.offending_line = line;
+            return;
+        }
+
+        if (more_columns)
+        {
+            parsed.error = "Expected two columns separated by '" + string(1, delim) + "' but got more.\n";
+            parsed.offending_line = line;
+            return;
+        }
+
+        size_t const first_letter = parsed.letters.size();
+        for (size_t i = 0; i < word.size();)
+        {
+            // most letters are ASCII, which is decoded right here
+            char32_t letter = static_cast<unsigned char>(word[i]);
+            size_t const length = letter < 0x80 ? 1 : Alphabet::decode_utf8(word.substr(i), letter);
+            if (length == 0)
+            {
+                parsed.letters.resize(first_letter);
+                parsed.error = "Solution word is not valid UTF-8 \n";
+                parsed.offending_line = line;
+                return;
+            }
+            i += length;
+
+            // make all letters upper case
+            letter = letter >= U'a' && letter <= U'z' ? letter - 0x20 : Alphabet::to_upper(letter);
+            parsed.letters.push_back(letter);
+            bool const is_new = letter < SMALL_LETTER_LIMIT
+                                ? !seen.test(letter)
+                                : find(parsed.alphabet.begin(), parsed.alphabet.end(), letter) == parsed.alphabet.end();
+            if (is_new)
+            {
+                if (letter < SMALL_LETTER_LIMIT)
+                    seen.set(letter);
+                parsed.alphabet.push_back(letter);
+            }
+        }
+        parsed.clues.push_back(clue);
+        parsed.clue_size += clue.size();
+        parsed.lengths.push_back(parsed.letters.size() - first_letter);
+    }
+}
+
+// Runs f(c) for every chunk c, each on its own thread
+template<typename F>
+void for_each_chunk(size_t chunk_count, F f)
+{
+    vector<std::thread> threads;
+    for (size_t c = 1; c < chunk_count; c++)
+    {
+        threads.emplace_back(f, c);
+    }
+    f(0);
+    for (auto &thread : threads)
+    {
+        thread.join();
+    }
+}
+
+} // namespace
+
 CSVWordProvider::CSVWordProvider(const string& csv_location,
                                  bool ignore_header, char delim) :
     m_csv_location(csv_location), m_ignore_header(ignore_header), m_delim(delim)
@@ -18,18 +151,9 @@ CSVWordProvider::CSVWordProvider(const string& csv_location,
       << "CSV location: " << csv_location << std::endl;
 }
 
-void CSVWordProvider::retrieve_word_list(WordList& words) const
+void CSVWordProvider::retrieve_word_list(WordStore& words) const
 {
-    // WordList words may have already some entries. Thus, get the highest
-    // existing id in it first.
-    wid next_id = 0;
-    for (auto const &word : words)
-    {
-        next_id = std::max(next_id, word.id);
-    }
-    next_id++;
-
-    std::ifstream csv_file(m_csv_location);
+    MappedFile const csv_file(m_csv_location);
     if (!csv_file.is_open())
     {
         throw runtime_error(
@@ -37,46 +161,94 @@ void CSVWordProvider::retrieve_word_list(WordList& words) const
                   "(Filename: " + m_csv_location + ")"
                   );
     }
+    string_view const text(csv_file.data(), csv_file.size());
 
-    string line;
+    size_t first_line = 0;
+    size_t begin = 0;
     if (m_ignore_header)
     {
-        std::getline(csv_file, line);
+        first_line = 1;
+        size_t const header_end = text.find('\n');
+        begin = header_end == string_view::npos ? text.size() : header_end + 1;
     }
 
-    while (std::getline(csv_file, line))
+    // split the file into chunks of whole lines, one per thread
+    size_t const thread_count = std::clamp<size_t>((text.size() - begin) / MIN_CHUNK_SIZE, 1,
+                                                   std::max(std::thread::hardware_concurrency(), 1u));
+    vector<size_t> chunk_starts = { begin };
+    for (size_t c = 1; c < thread_count; c++)
     {
-        stringstream tokens(line);
-        
-        string clue;
-        string word;
-        getline(tokens, clue, m_delim);
-        getline(tokens, word, m_delim);
-        // make all characters upper case
-        clue = trim(clue);
-        word = trim(word);
-        std::for_each(word.begin(), word.end(), [] (char &c) {
-            c = toupper(c);
-        });
+        size_t const split = begin + (text.size() - begin) * c / thread_count;
+        if (split <= chunk_starts.back())
+            continue;
+        size_t const line_end = text.find('\n', split - 1);
+        if (line_end == string_view::npos || line_end + 1 >= text.size())
+            break;
+        chunk_starts.push_back(line_end + 1);
+    }
+    chunk_starts.push_back(text.size());
+
+    vector<ParsedChunk> chunks(chunk_starts.size() - 1);
+    for_each_chunk(chunks.size(), [&](size_t c) {
+        parse_chunk(text.substr(chunk_starts[c], chunk_starts[c + 1] - chunk_starts[c]), m_delim, chunks[c]);
+    });
 
-        Word new_word(next_id++, clue, word);
-        if (new_word.clue.empty() || new_word.word.empty())
+    // report the first malformed line of the file
+    size_t line_number = first_line;
+    for (auto const &chunk : chunks)
+    {
+        line_number += chunk.line_count;
+        if (!chunk.error.empty())
         {
             throw runtime_error(
-                      "Invalid CSV line format! \n"
-                      "Clue or solution word is empty \n"
-                      "The offending line: " + line
+                      "Invalid CSV line format! \n" + chunk.error
+                      + "The offending line " + to_string(line_number) + ": " + string(chunk.offending_line)
                       );
         }
+    }
+
+    // the alphabet is built from the letters of all words
+    vector<char32_t> letters;
+    for (size_t code = 1; code < words.alphabet().size(); code++)
+    {
+        letters.push_back(words.alphabet().letter(code));
+    }
+    size_t word_count = 0, letter_count = 0, clue_count = 0;
+    for (auto const &chunk : chunks)
+    {
+        letters.insert(letters.end(), chunk.alphabet.begin(), chunk.alphabet.end());
+        word_count += chunk.clues.size();
+        letter_count += chunk.letters.size();
+        clue_count += chunk.clue_size;
+    }
+    Alphabet alphabet(std::move(letters));
+    if (!words.empty() && alphabet.size() != words.alphabet().size())
+        throw runtime_error("Cannot add words with new letters to a filled word store");
+
+    array<char, SMALL_LETTER_LIMIT> small_codes;
+    for (char32_t letter = 0; letter < SMALL_LETTER_LIMIT; letter++)
+    {
+        small_codes[letter] = alphabet.encode(letter);
+    }
+    for_each_chunk(chunks.size(), [&](size_t c) {
+        string &codes = chunks[c].codes;
+        codes.resize(chunks[c].letters.size());
+        std::transform(chunks[c].letters.begin(), chunks[c].letters.end(), codes.begin(), [&](char32_t letter) {
+            return letter < SMALL_LETTER_LIMIT ? small_codes[letter] : alphabet.encode(letter);
+        });
+    });
+    words.set_alphabet(std::move(alphabet));
 
-        words.push_back(new_word);
-        if (!tokens.eof())
+    words.reserve(word_count, letter_count, clue_count);
+    for (auto const &chunk : chunks)
+    {
+        string_view const letters = chunk.codes;
+        size_t offset = 0;
+        for (size_t i = 0; i < chunk.clues.size(); i++)
         {
-            throw runtime_error(
-                      "Invalid CSV line format! \n"
-                      "Expected two columns separated by '" + string(1, m_delim) + "' but got more.\n"
-                      "The offending line: " + line
-                      );
+            words.add(chunk.clues[i], letters.substr(offset, chunk.lengths[i]));
+            offset += chunk.lengths[i];
         }
     }
-}
\ No newline at end of file
+    words.build_length_tables();
+}
@@ -24,8 +24,8 @@ public:
 
     /**
        Retrieves a list of crossword words from the CSV file specified in
-       the constructor call and appends it to a WordList.
-       @param wordlist The word list to which the retrieved words are appended to.
+       the constructor call and appends it to a WordStore.
+       @param words The word store to which the retrieved words are appended to.
      */
-    void retrieve_word_list(WordList& wordlist) const override;
+    void retrieve_word_list(WordStore& words) const override;
 };
\ No newline at end of file
@@ -0,0 +1,62 @@
+#include <algorithm>
+
+#include "engine.h"
+#include "randomengine.h"
+#include "backtrackingengine.h"
+#include "beamengine.h"
+#include "subsetengine.h"
+#include "simplescorer.h"
+#include "layoutscorer.h"
+
+using namespace search;
+
+void Engine::prefer_first_word_last(std::vector<wid> &words, Heuristics const &heuristics)
+{
+    auto const candidate = std::find_if(words.rbegin(), words.rend(),
+                                        [&heuristics](wid word) { return heuristics.is_first_word_candidate(word); });
+    if (candidate != words.rend())
+    {
+        std::iter_swap(candidate, words.rbegin());
+    }
+}
+
+bool Engine::picks_words() const
+{
+    return false;
+}
+
+std::size_t Engine::get_word_count(WordStore const &words) const
+{
+    return words.size();
+}
+
+bool Engine::has_type(std::string const &type)
+{
+    return type == "random" || type == "backtracking" || type == "beam" || type == "subset";
+}
+
+template<typename ScorerPolicy>
+std::unique_ptr<BasicEngine<ScorerPolicy> > BasicEngine<ScorerPolicy>::create(std::string const &type,
+                                                                              INIReader const &config)
+{
+    if (type == "random")
+    {
+        return std::make_unique<RandomEngine<ScorerPolicy> >();
+    }
+    if (type == "backtracking")
+    {
+        return std::make_unique<BacktrackingEngine<ScorerPolicy> >(config);
+    }
+    if (type == "beam")
+    {
+        return std::make_unique<BeamEngine<ScorerPolicy> >(config);
+    }
+    if (type == "subset")
+    {
+        return std::make_unique<SubsetEngine<ScorerPolicy> >(config);
+    }
+    return nullptr;
+}
+
+template class search::BasicEngine<scoring::SimpleScorerPolicy>;
+template class search::BasicEngine<scoring::LayoutScorerPolicy>;
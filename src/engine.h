@@ -0,0 +1,131 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "crossingindex.h"
+#include "grid.h"
+#include "heuristics.h"
+#include "patternindex.h"
+#include "scorer.h"
+#include "transpositiontable.h"
+#include "word.h"
+
+#include "INIReader.h"
+
+namespace search {
+
+/**
+    Per-worker state handed to an engine for a single restart.
+ */
+template<typename ScorerPolicy>
+struct Context
+{
+    std::default_random_engine &rng;
+    ScorerPolicy const &scorer;
+    // engines whose restarts may take long must return once this is passed
+    std::chrono::steady_clock::time_point deadline;
+    // Hashes of the partial grids the engine explored in the current restart.
+    // Engines skip partial grids found in here, as the same words at the same
+    // relative places were searched from before. It is cleared for every
+    // restart: the node limit cuts searches short, so a partial grid a
+    // previous restart explored was not necessarily searched completely.
+    TranspositionTable &explored;
+    // Grids owned by the worker that engines keep between restarts instead of
+    // allocating them anew. Engines take grids from here and put them back
+    // before they return; a grid taken must be reset() or assign()-ed first.
+    std::vector<std::unique_ptr<grid::Grid> > &spare_grids;
+    // Indexes of the words the grids are filled with, shared by all workers.
+    // Only the one the engine uses is built, see Engine::picks_words().
+    CrossingIndex const &crossings;
+    PatternIndex const &patterns;
+    // built along with the crossing index
+    Heuristics const &heuristics;
+    // Score a grid must beat to get into the generator's result pool, see
+    // snapshot::ResultPool::get_threshold(). A restart whose partial grid
+    // cannot beat it any more, see Scorer::upper_bound(), may be abandoned.
+    std::atomic<scoring::score> const &pool_threshold;
+    // set by the engine if it abandoned the restart
+    bool abandoned;
+};
+
+/**
+    The parts of the search engines that do not depend on the scorer policy,
+    see BasicEngine.
+ */
+class Engine
+{
+protected:
+    /**
+        Moves the last word of 'words' that may be the first word of a grid
+        to the back of 'words', if there is any. See Heuristics::is_first_word_candidate().
+     */
+    static void prefer_first_word_last(std::vector<wid> &words, Heuristics const &heuristics);
+
+public:
+    /**
+        Checks if there is an engine of type 'type', see BasicEngine::create().
+     */
+    static bool has_type(std::string const &type);
+
+    virtual ~Engine() = default;
+
+    /**
+        Checks if the engine picks a subset of the words from a large word
+        list. Such engines get the pattern index, the others the crossing
+        index, which grows quadratically with the number of words.
+     */
+    virtual bool picks_words() const;
+
+    /**
+        Number of words a filled grid is meant to hold. Fewer words are
+        scored as unplaced words.
+     */
+    virtual std::size_t get_word_count(WordStore const &words) const;
+
+};
+
+/**
+    Search engine scoring with the scorer policy ScorerPolicy, like
+    BasicGenerator. The engines are instantiated for every policy in their
+    .cpp files, so the bounds and scores of the partial grids call the
+    policy directly instead of through scoring::Scorer.
+ */
+template<typename ScorerPolicy>
+class BasicEngine : public Engine
+{
+protected:
+    /**
+        Checks if no grid the partial grid 'grid' can be extended to gets into
+        the result pool. See Scorer::upper_bound() for the parameters.
+     */
+    static bool is_hopeless(grid::Grid const &grid, std::int_fast32_t unplaced_word_count,
+                            std::int_fast32_t placeable_word_count, std::int_fast32_t placeable_letter_count,
+                            Context<ScorerPolicy> const &context)
+    {
+        // a grid with the same score as the worst kept one would not replace it either
+        return context.scorer.upper_bound(grid, unplaced_word_count, placeable_word_count, placeable_letter_count)
+               <= context.pool_threshold.load(std::memory_order_relaxed);
+    }
+
+public:
+    /**
+        Creates the engine of type 'type', or returns nullptr if there is no
+        such engine.
+     */
+    static std::unique_ptr<BasicEngine> create(std::string const &type, INIReader const &config);
+
+    /**
+        Places words of 'words' on the empty grid 'grid', which has been
+        created for this word store. Note that the generator
+        calls this concurrently from all of its worker threads, so implementations
+        must not modify shared state.
+     */
+    virtual void fill_grid(grid::Grid &grid, WordStore const &words, Context<ScorerPolicy> &context) const = 0;
+};
+
+} // namespace search
@@ -1,10 +1,19 @@
 #include <algorithm>
 #include <chrono>
 #include <iostream>
+#include <limits>
 #include <filesystem>
+#include <sstream>
+#include <stdexcept>
 #include <string>
+#include <thread>
+#include <vector>
 
+#include "compiledwordprovider.h"
 #include "generator.h"
+#include "segmentmatch.h"
+#include "layoutscorer.h"
+#include "simplescorer.h"
 #include "latexgenerator.h"
 
 #include "INIReader.h"
@@ -13,101 +22,429 @@
 
 #define CONFIG_FILE "config.ini"
 
-Generator::Generator(std::int_fast32_t number_of_crosswords_to_generate,
-                     std::int_fast32_t crossword_max_width, std::int_fast32_t crossword_max_height,
-                     std::unique_ptr<WordProvider> provider, std::unique_ptr<scoring::Scorer> grid_scorer) :
-    m_rng(std::default_random_engine{}), m_gen_count(number_of_crosswords_to_generate),
+template<typename ScorerPolicy>
+BasicGenerator<ScorerPolicy>::BasicGenerator(StopCriteria const &stop_criteria, std::int_fast32_t thread_count,
+                                             std::int_fast32_t crossword_max_width,
+                                             std::int_fast32_t crossword_max_height,
+                                             std::size_t transposition_table_size,
+                                             SnapshotSettings const &snapshot_settings,
+                                             search::HeuristicSettings const &heuristic_settings,
+                                             std::unique_ptr<WordProvider> provider,
+                                             ScorerPolicy const &scorer_policy,
+                                             std::unique_ptr<search::BasicEngine<ScorerPolicy> > engine,
+                                             search::Annealer const &annealer) :
+    m_rng_seed(SEED_RNG), m_stop_criteria(stop_criteria),
+    m_thread_count(std::max<std::int_fast32_t>(thread_count, 1)),
     m_cw_max_width(crossword_max_width), m_cw_max_height(crossword_max_height),
-    m_grid_scorer(std::move(grid_scorer))
+    m_transposition_table_size(transposition_table_size),
+    m_grid_scorer(scorer_policy), m_engine(std::move(engine)), m_annealer(annealer),
+    m_next_restart(0), m_finished_restarts(0),
+    m_last_improvement(0), m_duplicate_grids(0), m_abandoned_restarts(0),
+    m_highest_score(std::numeric_limits<scoring::score>::min()),
+    m_pool_threshold(std::numeric_limits<scoring::score>::min()),
+    m_stop_reason(StopReason::NONE), m_snapshot_settings(snapshot_settings),
+    m_results(snapshot_settings.pool_size, snapshot_settings.min_difference)
 {
-    auto rng_seed = SEED_RNG;
-    m_rng.seed(rng_seed);
     provider->retrieve_word_list(word_list);
+    m_word_count = m_engine->get_word_count(word_list);
+    if (m_engine->picks_words())
+    {
+        m_patterns = PatternIndex(word_list);
+    }
+    else
+    {
+        m_crossings = CrossingIndex(word_list);
+        m_heuristics = search::Heuristics(heuristic_settings, word_list, m_crossings);
+    }
     std::cout << "Initialized crossword generator. " << std::endl;
-    std::cout << "Random generator seed is: " << rng_seed << std::endl;
+    std::cout << "Random generator seed is: " << m_rng_seed << std::endl;
+    std::cout << "Number of worker threads: " << m_thread_count << std::endl;
+    std::cout << "Transposition table size per worker: " << m_transposition_table_size << std::endl;
+    if (m_engine->picks_words())
+    {
+        std::cout << "Grids hold " << m_word_count << " out of " << word_list.size() << " words, picked with a "
+                  << m_patterns.memory_size() / 1024 << " KiB pattern index" << std::endl;
+    }
+    else
+    {
+        std::cout << "Crossing index holds " << m_crossings.size() << " crossings, "
+                  << m_crossings.get_uncrossable_count() << " words cannot cross any other word" << std::endl;
+    }
+    std::cout << "Keeping the " << m_snapshot_settings.pool_size << " best grids differing in at least "
+              << m_snapshot_settings.min_difference << " words" << std::endl;
+    if (!m_snapshot_settings.pool_file.empty())
+    {
+        std::cout << "Saving them to " << m_snapshot_settings.pool_file << " every "
+                  << m_snapshot_settings.checkpoint_interval << " grids" << std::endl;
+    }
+    std::cout << "Grid segment matching uses: " << grid::segment_match_implementation() << std::endl;
+    std::cout << "Grid functions specialized for the maximum size: "
+              << (grid::Grid::has_fixed_dimensions(m_cw_max_height, m_cw_max_width) ? "yes" : "no") << std::endl;
 }
 
-std::unique_ptr<grid::Grid> Generator::generate_single_grid()
+template<typename ScorerPolicy>
+std::pair<std::unique_ptr<grid::Grid>, scoring::score>
+BasicGenerator<ScorerPolicy>::run_worker(std::int_fast32_t worker_id)
 {
-    std::uniform_int_distribution<int> dist(0, 1); // for generating random vert/horizontal
-    auto grid = std::make_unique<grid::Grid>(m_cw_max_height, m_cw_max_width);
-    WordList unused_words(word_list);
+    // every worker gets its own random stream, see open_pool()
+    std::default_random_engine rng = m_worker_rngs[worker_id];
+    // Grids built by this worker with their scores, and the partial grids its
+    // engine explored in the current restart. Different restarts often end up
+    // with the same grid, especially for small word lists, which then need
+    // not be scored again.
+    search::TranspositionTable built_grids(m_transposition_table_size);
+    search::TranspositionTable explored(m_transposition_table_size);
+    std::vector<std::unique_ptr<grid::Grid> > spare_grids;
+    search::Context<ScorerPolicy> context = { rng, m_grid_scorer.policy(), std::chrono::steady_clock::time_point::max(),
+                                              explored, spare_grids, m_crossings, m_patterns, m_heuristics,
+                                              m_pool_threshold, false };
+    if (m_stop_criteria.time_budget.count() > 0)
+    {
+        context.deadline = m_restart_deadline;
+    }
 
-    // place random first word
-    std::shuffle(std::begin(unused_words), std::end(unused_words), m_rng);
-    Word const first_word = unused_words.back();
-    grid::Direction const first_dir = static_cast<grid::Direction>(dist(m_rng));
+    // A worker only ever owns two grids: the best one so far and a scratch
+    // grid that is reset and reused for every restart. If the scratch grid
+    // turns out better, the two swap roles.
+    std::unique_ptr<grid::Grid> best_grid = nullptr;
+    std::unique_ptr<grid::Grid> grid = nullptr;
+    scoring::score highest_grid_score = 0;
+    while (m_stop_reason == StopReason::NONE)
+    {
+        auto restart = m_next_restart++;
+        if (!may_start_restart(restart))
+            break;
 
-    grid->place_first_word(first_word, first_dir);
-    unused_words.pop_back();
+        if (grid == nullptr)
+        {
+            grid = std::make_unique<grid::Grid>(word_list, m_cw_max_height, m_cw_max_width);
+        }
+        else
+        {
+            grid->reset();
+        }
+        context.abandoned = false;
+        explored.clear();
+        m_engine->fill_grid(*grid, word_list, context);
+        if (context.abandoned)
+        {
+            m_abandoned_restarts++;
+        }
+        scoring::score grid_score;
+        if (scoring::score const *known_score = built_grids.find(grid->get_hash()))
+        {
+            grid_score = *known_score;
+            m_duplicate_grids++;
+        }
+        else
+        {
+            std::int_fast32_t unplaced_words = std::max<std::int_fast32_t>(
+                static_cast<std::int_fast32_t>(m_word_count) - grid->get_placed_word_count(), 0);
+            grid_score = m_grid_scorer.policy().score_grid(*grid, unplaced_words);
+            built_grids.insert(grid->get_hash(), grid_score);
+        }
+        // an abandoned grid cannot get into the pool
+        auto const finished_restarts = context.abandoned ? ++m_finished_restarts
+                                                         : record_result(worker_id, rng, *grid, grid_score);
 
-    // in every iteration, shuffle not yet placed words and try to add them at
-    // random valid location in shuffle order. Repeat until no words are left
-    // or no remaining word can be placed.
-    while (unused_words.size() != 0)
+        if (best_grid == nullptr || grid_score > highest_grid_score)
+        {
+            highest_grid_score = grid_score;
+            std::swap(best_grid, grid);
+        }
+
+        record_score(restart, grid_score);
+        report_progress(finished_restarts);
+    }
+
+    // polish the best grid, unless it is already good enough
+    if (best_grid != nullptr && m_annealer.is_enabled() && m_stop_reason != StopReason::TARGET_SCORE)
     {
-        bool word_placed = false;
-        std::shuffle(std::begin(unused_words), std::end(unused_words), m_rng);
+        auto deadline = std::chrono::steady_clock::time_point::max();
+        if (m_stop_criteria.time_budget.count() > 0)
+        {
+            deadline = m_deadline;
+        }
+        highest_grid_score = m_annealer.improve(*best_grid, word_list, m_word_count, m_grid_scorer.policy(), rng,
+                                                deadline);
+    }
+
+    return { std::move(best_grid), highest_grid_score };
+}
+
+template<typename ScorerPolicy>
+bool BasicGenerator<ScorerPolicy>::may_start_restart(std::int_fast32_t restart)
+{
+    if (restart == 0)
+        return true;
 
-        WordList unplaced_words;
-        for (auto const &word : unused_words)
+    if (m_stop_criteria.max_restarts > 0 && restart >= m_stop_criteria.max_restarts)
+    {
+        request_stop(StopReason::RESTART_LIMIT);
+        return false;
+    }
+    if (m_stop_criteria.time_budget.count() > 0 && std::chrono::steady_clock::now() >= m_restart_deadline)
+    {
+        request_stop(StopReason::TIME_BUDGET);
+        return false;
+    }
+    return true;
+}
+
+template<typename ScorerPolicy>
+void BasicGenerator<ScorerPolicy>::record_score(std::int_fast32_t restart, scoring::score grid_score)
+{
+    auto highest = m_highest_score.load();
+    bool improved = false;
+    while (grid_score > highest && !(improved = m_highest_score.compare_exchange_weak(highest, grid_score)))
+    {
+    }
+
+    if (improved)
+    {
+        auto last = m_last_improvement.load();
+        while (restart > last && !m_last_improvement.compare_exchange_weak(last, restart))
         {
-            std::vector<grid::Location> valid_placements;
-            grid->get_valid_placements(word, valid_placements);
-            if (valid_placements.size() == 0)
-            {
-                unplaced_words.push_back(word);
-            }
-            else
+        }
+    }
+
+    if (m_stop_criteria.target_score && grid_score >= *m_stop_criteria.target_score)
+    {
+        request_stop(StopReason::TARGET_SCORE);
+    }
+    else if (m_stop_criteria.stall_window > 0
+             && restart - m_last_improvement.load() >= m_stop_criteria.stall_window)
+    {
+        request_stop(StopReason::STALLED);
+    }
+}
+
+template<typename ScorerPolicy>
+void BasicGenerator<ScorerPolicy>::request_stop(StopReason reason)
+{
+    StopReason expected = StopReason::NONE;
+    m_stop_reason.compare_exchange_strong(expected, reason);
+}
+
+template<typename ScorerPolicy>
+void BasicGenerator<ScorerPolicy>::report_progress(std::int_fast32_t finished_restarts)
+{
+    if (finished_restarts % PROGRESS_EVER_N_GRIDS == 0)
+    {
+        std::lock_guard<std::mutex> lock(m_console_mutex);
+        std::cout << "Generated " << finished_restarts;
+        if (m_stop_criteria.max_restarts > 0)
+            std::cout << " out of " << m_stop_criteria.max_restarts;
+        std::cout << " grids. " << std::endl;
+        std::cout << "The current best grid has a score of " << m_highest_score.load() << "." << std::endl;
+    }
+}
+
+template<typename ScorerPolicy>
+void BasicGenerator<ScorerPolicy>::open_pool()
+{
+    m_worker_rngs.clear();
+    m_results.clear();
+    m_last_checkpoint = 0;
+    m_pool_writer = nullptr;
+
+    std::string const &location = m_snapshot_settings.pool_file;
+    if (!location.empty() && m_snapshot_settings.resume && std::filesystem::exists(location))
+    {
+        snapshot::Checkpoint checkpoint = snapshot::read_last_checkpoint(location, word_list,
+                                                                         m_cw_max_height, m_cw_max_width);
+        m_rng_seed = checkpoint.rng_seed;
+        m_next_restart = checkpoint.finished_restarts;
+        m_finished_restarts = checkpoint.finished_restarts;
+        m_last_checkpoint = checkpoint.finished_restarts;
+        m_last_improvement = checkpoint.finished_restarts;
+        for (auto const &saved : checkpoint.pool)
+        {
+            m_results.add(saved);
+        }
+        if (!checkpoint.pool.empty())
+        {
+            m_highest_score = checkpoint.pool.front().grid_score;
+        }
+        // the random streams only continue where they were if the workers are the same
+        if (checkpoint.rng_states.size() == static_cast<std::size_t>(m_thread_count))
+        {
+            for (auto const &state : checkpoint.rng_states)
             {
-                std::uniform_int_distribution<int> rng(0, valid_placements.size() - 1);
-                grid::Location rand_loc = valid_placements[rng(m_rng)];
-                grid->place_word_unchecked(word, rand_loc);
-                word_placed = true;
+                std::istringstream in(state);
+                in >> m_worker_rngs.emplace_back();
             }
         }
-        unused_words = std::move(unplaced_words);
+        std::cout << "Resuming from " << location << " after " << checkpoint.finished_restarts
+                  << " grids with seed " << m_rng_seed << " and " << m_results.size() << " saved grids" << std::endl;
+    }
 
-        if (!word_placed)
-            break;
+    m_pool_threshold = m_results.get_threshold();
+
+    if (m_worker_rngs.empty())
+    {
+        for (auto w = 0; w < m_thread_count; w++)
+        {
+            // every worker gets its own random stream, derived from the global seed
+            std::seed_seq worker_seed{ m_rng_seed, static_cast<unsigned int>(w) };
+            m_worker_rngs.emplace_back(worker_seed);
+        }
     }
 
-    return grid;
+    if (!location.empty())
+    {
+        m_pool_writer = std::make_unique<snapshot::PoolWriter>(location, word_list, m_cw_max_height,
+                                                               m_cw_max_width);
+    }
+}
+
+template<typename ScorerPolicy>
+std::int_fast32_t BasicGenerator<ScorerPolicy>::record_result(std::int_fast32_t worker_id,
+                                                              std::default_random_engine const &rng,
+                                                              grid::Grid const &grid, scoring::score grid_score)
+{
+    std::lock_guard<std::mutex> lock(m_pool_mutex);
+    // counted under the lock, so that the checkpoints are written in order
+    auto const finished_restarts = ++m_finished_restarts;
+    add_to_pool(grid, grid_score);
+    if (m_pool_writer == nullptr)
+        return finished_restarts;
+
+    m_worker_rngs[worker_id] = rng;
+    // abandoned restarts are counted without the lock and may skip a multiple
+    // of the interval
+    if (m_snapshot_settings.checkpoint_interval > 0
+        && finished_restarts - m_last_checkpoint >= m_snapshot_settings.checkpoint_interval)
+    {
+        write_checkpoint(finished_restarts);
+    }
+    return finished_restarts;
+}
+
+template<typename ScorerPolicy>
+void BasicGenerator<ScorerPolicy>::add_to_pool(grid::Grid const &grid, scoring::score grid_score)
+{
+    // most grids are worse than the pool's worst one and need not be captured
+    if (m_results.accepts(grid_score))
+    {
+        m_results.add(snapshot::capture(grid, grid_score));
+        m_pool_threshold.store(m_results.get_threshold(), std::memory_order_relaxed);
+    }
 }
 
-std::unique_ptr<grid::Grid> Generator::generate()
+template<typename ScorerPolicy>
+void BasicGenerator<ScorerPolicy>::write_checkpoint(std::int_fast32_t finished_restarts)
 {
-    std::cout << "Generating " << m_gen_count << " grids and choosing the best" << std::endl;
+    if (finished_restarts < m_last_checkpoint)
+        return;
+    m_last_checkpoint = finished_restarts;
+
+    snapshot::Checkpoint checkpoint = { m_rng_seed, finished_restarts, {}, m_results.best_first() };
+    for (auto const &rng : m_worker_rngs)
+    {
+        std::ostringstream out;
+        out << rng;
+        checkpoint.rng_states.push_back(out.str());
+    }
+
+    try
+    {
+        m_pool_writer->write(checkpoint);
+    }
+    catch (std::runtime_error const &error)
+    {
+        std::lock_guard<std::mutex> console_lock(m_console_mutex);
+        std::cerr << "Error: " << error.what() << ". No further checkpoints are written." << std::endl;
+        m_pool_writer = nullptr;
+    }
+}
+
+static char const * stop_reason_to_string(StopReason reason)
+{
+    switch (reason)
+    {
+    case StopReason::RESTART_LIMIT:
+        return "all requested grids were generated";
+    case StopReason::TIME_BUDGET:
+        return "the time budget is used up";
+    case StopReason::TARGET_SCORE:
+        return "the target score was reached";
+    case StopReason::STALLED:
+        return "the best score stopped improving";
+    case StopReason::NONE:
+        break;
+    }
+    return "unknown";
+}
+
+template<typename ScorerPolicy>
+std::unique_ptr<grid::Grid> BasicGenerator<ScorerPolicy>::generate()
+{
+    std::cout << "Generating grids on " << m_thread_count
+              << " threads and choosing the best" << std::endl;
     auto begin = std::chrono::high_resolution_clock::now();
 
-    std::unique_ptr<grid::Grid> best_grid = nullptr;
-    scoring::score highest_grid_score = 0;
-    for (auto i = 1; i <= m_gen_count; i++)
+    m_deadline = std::chrono::steady_clock::now() + m_stop_criteria.time_budget;
+    m_restart_deadline = m_deadline;
+    if (m_annealer.is_enabled())
     {
-        auto grid = generate_single_grid();
-        std::int_fast32_t unplaced_words = word_list.size() - grid->get_placed_word_count();
-        scoring::score grid_score = m_grid_scorer->score_grid(*grid, unplaced_words);
+        m_restart_deadline -= std::min(m_annealer.get_time_budget(), m_stop_criteria.time_budget / 2);
+    }
+    m_next_restart = 0;
+    m_finished_restarts = 0;
+    m_last_improvement = 0;
+    m_duplicate_grids = 0;
+    m_abandoned_restarts = 0;
+    m_highest_score = std::numeric_limits<scoring::score>::min();
+    m_stop_reason = StopReason::NONE;
+    open_pool();
+
+    std::vector<std::pair<std::unique_ptr<grid::Grid>, scoring::score> > results(m_thread_count);
+    std::vector<std::thread> workers;
+    for (auto w = 1; w < m_thread_count; w++)
+    {
+        workers.emplace_back([this, w, &results] { results[w] = run_worker(w); });
+    }
+    // the calling thread is worker 0
+    results[0] = run_worker(0);
+    for (auto &worker : workers)
+    {
+        worker.join();
+    }
 
-        if (best_grid == nullptr || grid_score > highest_grid_score)
+    // The annealed grids did not go through record_result(). The workers are
+    // added in order, so ties go to the lowest worker id.
+    {
+        std::lock_guard<std::mutex> lock(m_pool_mutex);
+        for (auto &[grid, grid_score] : results)
         {
-            highest_grid_score = grid_score;
-            best_grid = std::move(grid);
+            if (grid != nullptr)
+            {
+                add_to_pool(*grid, grid_score);
+            }
         }
-
-        if (i % PROGRESS_EVER_N_GRIDS == 0)
+        if (m_pool_writer != nullptr)
         {
-            std::cout << "Generated " << i << " out of " << m_gen_count << " grids. " << std::endl;
-            std::cout << "The current best grid has a score of "
-                      << highest_grid_score << ". It is: " << std::endl;
-            best_grid->print_on_console();
+            write_checkpoint(m_finished_restarts);
         }
     }
 
+    // The best grid is the first of the pool. It is rebuilt from its snapshot,
+    // as a resumed run may not have found a grid as good as the saved ones.
+    std::vector<snapshot::GridSnapshot> const kept = m_results.best_first();
+    std::unique_ptr<grid::Grid> best_grid = restore(kept.front());
+    scoring::score const highest_grid_score = kept.front().grid_score;
+
     auto end = std::chrono::high_resolution_clock::now();
     auto duration = end - begin;
     auto dur_in_ms = std::chrono::duration_cast<std::chrono::milliseconds>(duration).count();
-    std::cout << "Generated all " << m_gen_count << " grids!" << std::endl;
+    std::cout << "Generated " << m_finished_restarts << " grids and stopped because "
+              << stop_reason_to_string(m_stop_reason) << "." << std::endl;
+    std::cout << m_duplicate_grids << " of these were built before and not scored again." << std::endl;
+    std::cout << m_abandoned_restarts << " were abandoned early, as they could not get into the result pool." << std::endl;
     std::cout << "This took me a total of " << dur_in_ms / 1000.0 << " seconds." << std::endl;
+    std::cout << "Kept the " << kept.size() << " best distinct grids, with scores from "
+              << kept.back().grid_score << " to " << highest_grid_score << "." << std::endl;
     std::cout << "The final grid has a score of "
               << highest_grid_score << ". It is: " << std::endl;
     best_grid->print_on_console();
@@ -115,9 +452,71 @@ std::unique_ptr<grid::Grid> Generator::generate()
     return best_grid;
 }
 
+template<typename ScorerPolicy>
+std::vector<snapshot::GridSnapshot> BasicGenerator<ScorerPolicy>::get_results() const
+{
+    return m_results.best_first();
+}
 
-int main(__attribute__((unused)) int argc, char* argv[])
+template<typename ScorerPolicy>
+std::unique_ptr<grid::Grid> BasicGenerator<ScorerPolicy>::restore(snapshot::GridSnapshot const &result) const
 {
+    auto grid = std::make_unique<grid::Grid>(word_list, m_cw_max_height, m_cw_max_width);
+    snapshot::restore(result, *grid);
+    return grid;
+}
+
+template class BasicGenerator<scoring::SimpleScorerPolicy>;
+template class BasicGenerator<scoring::LayoutScorerPolicy>;
+
+std::unique_ptr<Generator> Generator::create(std::string const &scorer_type, INIReader const &config,
+                                             StopCriteria const &stop_criteria, std::int_fast32_t thread_count,
+                                             std::int_fast32_t crossword_max_width,
+                                             std::int_fast32_t crossword_max_height,
+                                             std::size_t transposition_table_size,
+                                             SnapshotSettings const &snapshot_settings,
+                                             search::HeuristicSettings const &heuristic_settings,
+                                             std::unique_ptr<WordProvider> provider,
+                                             std::string const &engine_type,
+                                             search::Annealer const &annealer)
+{
+    if (scorer_type == "simple")
+    {
+        return std::make_unique<BasicGenerator<scoring::SimpleScorerPolicy> >(
+                   stop_criteria, thread_count, crossword_max_width, crossword_max_height,
+                   transposition_table_size, snapshot_settings, heuristic_settings, std::move(provider),
+                   scoring::SimpleScorerPolicy(config),
+                   search::BasicEngine<scoring::SimpleScorerPolicy>::create(engine_type, config), annealer);
+    }
+    if (scorer_type == "layout")
+    {
+        return std::make_unique<BasicGenerator<scoring::LayoutScorerPolicy> >(
+                   stop_criteria, thread_count, crossword_max_width, crossword_max_height,
+                   transposition_table_size, snapshot_settings, heuristic_settings, std::move(provider),
+                   scoring::LayoutScorerPolicy(config),
+                   search::BasicEngine<scoring::LayoutScorerPolicy>::create(engine_type, config), annealer);
+    }
+    return nullptr;
+}
+
+
+int main(int argc, char* argv[])
+{
+    if (argc == 4 && std::string(argv[1]) == "--compile-wordlist")
+    {
+        // generator --compile-wordlist <csv file> <compiled word list>
+        try
+        {
+            CompiledWordProvider::compile(argv[2], argv[3]);
+        }
+        catch (std::runtime_error const &error)
+        {
+            std::cerr << "Error: " << error.what() << std::endl;
+            return -1;
+        }
+        return 0;
+    }
+
     std::cout << "Starting crossword generator." << std::endl;
 
     std::filesystem::path exec_path = argv[0];
@@ -134,22 +533,83 @@ int main(__attribute__((unused)) int argc, char* argv[])
 
     std::filesystem::path wordlistloc = exec_path.parent_path()
                                         .append(reader.Get("wordlist", "location", "INVALID"));
+    std::string wordlist_source = reader.Get("wordlist", "source", "");
+    if (!wordlist_source.empty())
+    {
+        wordlist_source = exec_path.parent_path().append(wordlist_source).string();
+    }
 
+    // a generation count of 0 means no limit, the run is then ended by one of
+    // the other stop criteria
     auto cw_gen_count = reader.GetInteger("constraints", "crossword_generation_count", -1);
+    auto cw_time_budget = reader.GetInteger("constraints", "time_budget_ms", 0);
+    auto cw_stall_window = reader.GetInteger("constraints", "stall_restart_window", 0);
     auto cw_max_height = reader.GetInteger("constraints", "max_height", -1);
     auto cw_max_width = reader.GetInteger("constraints", "max_width", -1);
+    // 0 (the default) uses one thread per hardware thread
+    auto cw_thread_count = reader.GetInteger("constraints", "thread_count", 0);
+    auto transposition_table_size = reader.GetInteger("generator", "transposition_table_size", 65536);
+    auto checkpoint_interval = reader.GetInteger("snapshot", "checkpoint_interval", 100);
+    auto result_count = reader.GetInteger("results", "count", 20);
+    auto min_difference = reader.GetInteger("results", "min_difference", 5);
+    if (cw_thread_count == 0)
+    {
+        cw_thread_count = std::max(std::thread::hardware_concurrency(), 1u);
+    }
 
-    if (cw_gen_count < 0 || cw_max_height < 0 || cw_max_width < 0)
+    if (cw_gen_count < 0 || cw_max_height < 0 || cw_max_width < 0 || cw_thread_count < 0
+        || cw_time_budget < 0 || cw_stall_window < 0 || transposition_table_size < 0
+        || checkpoint_interval < 0 || result_count < 1 || min_difference < 1)
     {
         std::cerr << "Error reading crossword constraints from config!" << std::endl;
         return -1;
     }
 
+    if (cw_gen_count == 0 && cw_time_budget == 0 && cw_stall_window == 0)
+    {
+        std::cerr << "Error: crossword_generation_count is unlimited, but neither "
+                  << "time_budget_ms nor stall_restart_window is set!" << std::endl;
+        return -1;
+    }
+
+    StopCriteria stop_criteria = { cw_gen_count, std::chrono::milliseconds(cw_time_budget),
+                                   std::nullopt, cw_stall_window };
+    if (!reader.Get("constraints", "target_score", "").empty())
+    {
+        stop_criteria.target_score = reader.GetInteger("constraints", "target_score", 0);
+    }
+
+    SnapshotSettings snapshot_settings = { "", checkpoint_interval, static_cast<std::size_t>(result_count),
+                                           min_difference, reader.GetBoolean("snapshot", "resume", false) };
+    std::string const pool_file = reader.Get("snapshot", "pool_file", "");
+    if (!pool_file.empty())
+    {
+        snapshot_settings.pool_file = exec_path.parent_path().append(pool_file);
+    }
+
+    std::string const first_word = reader.Get("generator", "first_word", "random");
+    std::string const word_order = reader.Get("generator", "word_order", "random");
+    std::string const placement = reader.Get("generator", "placement", "random");
+    if ((first_word != "random" && first_word != "most_connected")
+        || (word_order != "random" && word_order != "hardest_first")
+        || (placement != "random" && placement != "most_crossings"))
+    {
+        std::cerr << "Error: Unknown first_word, word_order or placement heuristic in config!" << std::endl;
+        return -1;
+    }
+    search::HeuristicSettings const heuristic_settings = {
+        first_word == "random" ? search::FirstWordRule::RANDOM : search::FirstWordRule::MOST_CONNECTED,
+        word_order == "random" ? search::WordOrderRule::RANDOM : search::WordOrderRule::HARDEST_FIRST,
+        placement == "random" ? search::PlacementRule::RANDOM : search::PlacementRule::MOST_CROSSINGS
+    };
+
     std::string const wordprovider_type = reader.Get("wordlist", "type", "INVALID");
     std::string const scorer_type = reader.Get("scoring", "type", "INVALID");
+    std::string const engine_type = reader.Get("generator", "type", "random");
 
-    auto wordprovider = WordProvider::create(wordprovider_type, wordlistloc);
-    auto scorer = scoring::Scorer::create(scorer_type, reader);
+    auto wordprovider = WordProvider::create(wordprovider_type, wordlistloc, wordlist_source,
+                                             reader.GetBoolean("wordlist", "verify", false));
+    search::Annealer annealer(reader);
 
     if (wordprovider == nullptr)
     {
@@ -158,20 +618,44 @@ int main(__attribute__((unused)) int argc, char* argv[])
         return -1;
     }
 
-    if (scorer == nullptr)
+    if (!search::Engine::has_type(engine_type))
+    {
+        std::cerr << "Error: Could not create generator engine of type '"
+                  << engine_type << "'" << std::endl;
+        return -1;
+    }
+
+    auto generator = Generator::create(scorer_type, reader, stop_criteria, cw_thread_count, cw_max_width,
+                                       cw_max_height, transposition_table_size, snapshot_settings,
+                                       heuristic_settings, std::move(wordprovider), engine_type, annealer);
+    if (generator == nullptr)
     {
         std::cerr << "Error: Could not create scorer of type '"
                   << scorer_type << "'" << std::endl;
         return -1;
     }
 
-    Generator generator(cw_gen_count, cw_max_width, cw_max_height,
-                        std::move(wordprovider), std::move(scorer));
-
-    std::unique_ptr<grid::Grid> grid = generator.generate();
+    std::unique_ptr<grid::Grid> grid;
+    std::vector<snapshot::GridSnapshot> results;
+    try
+    {
+        grid = generator->generate();
+        results = generator->get_results();
+    }
+    catch (std::runtime_error const &error)
+    {
+        std::cerr << "Error: " << error.what() << std::endl;
+        return -1;
+    }
 
     LatexGenerator to_latex;
     to_latex.generate(grid.get(), "bin/testfile.tex");
+    // the other kept grids, one at a time, for picking another one than the best
+    for (std::size_t rank = 1; rank < results.size(); rank++)
+    {
+        to_latex.generate(generator->restore(results[rank]).get(),
+                          "bin/testfile_" + std::to_string(rank + 1) + ".tex");
+    }
     
     return 0;
 }
@@ -1,32 +1,231 @@
 #pragma once
 
+#include <atomic>
+#include <chrono>
 #include <cstdint>
+#include <memory>
+#include <mutex>
+#include <optional>
 #include <random>
+#include <string>
 #include <utility>
+#include <vector>
 
+#include "annealer.h"
+#include "crossingindex.h"
+#include "engine.h"
+#include "heuristics.h"
+#include "patternindex.h"
+#include "resultpool.h"
 #include "wordprovider.h"
 #include "scorer.h"
+#include "snapshot.h"
 #include "grid.h"
 
+#include "INIReader.h"
+
+/**
+    Conditions that end a generation run. The run stops as soon as any
+    of the enabled conditions is met. A value of 0 disables a condition.
+ */
+typedef struct StopCriteria
+{
+    // maximum number of restarts (grids) to generate
+    std::int_fast32_t max_restarts;
+    // wall-clock budget of the whole run
+    std::chrono::milliseconds time_budget;
+    // stop once a grid reaches at least this score
+    std::optional<scoring::score> target_score;
+    // stop once the best score did not improve for this many restarts
+    std::int_fast32_t stall_window;
+} StopCriteria;
+
+/**
+    Which of the best grids of a run are kept, and where and how often they
+    and the state of the run are saved, so that an interrupted run can be resumed.
+ */
+typedef struct SnapshotSettings
+{
+    // pool file holding the last checkpoint, written to <pool_file>.tmp and
+    // renamed over it; empty disables snapshots
+    std::string pool_file;
+    // number of finished restarts between two checkpoints
+    std::int_fast32_t checkpoint_interval;
+    // number of best grids kept, see snapshot::ResultPool
+    std::size_t pool_size;
+    // number of words any two kept grids differ in at least
+    std::int_fast32_t min_difference;
+    // continue from the last checkpoint of pool_file, if the file exists
+    bool resume;
+} SnapshotSettings;
+
+enum class StopReason
+{
+    NONE,
+    RESTART_LIMIT,
+    TIME_BUDGET,
+    TARGET_SCORE,
+    STALLED
+};
+
+/**
+    Generates grids from a word list and returns the best one. Generators are
+    created for a scorer type by create(), which picks the instantiation of
+    BasicGenerator for the scorer's policy.
+ */
 class Generator
 {
+public:
+    /**
+        @return a generator scoring with the scorer of the given type and
+        searching with the engine of type engine_type, see
+        search::BasicEngine::create(), or nullptr if there is no such scorer
+     */
+    static std::unique_ptr<Generator> create(std::string const &scorer_type, INIReader const &config,
+                                             StopCriteria const &stop_criteria, std::int_fast32_t thread_count,
+                                             std::int_fast32_t crossword_max_width,
+                                             std::int_fast32_t crossword_max_height,
+                                             std::size_t transposition_table_size,
+                                             SnapshotSettings const &snapshot_settings,
+                                             search::HeuristicSettings const &heuristic_settings,
+                                             std::unique_ptr<WordProvider> provider,
+                                             std::string const &engine_type,
+                                             search::Annealer const &annealer);
+
+    virtual ~Generator() = default;
+
+    virtual std::unique_ptr<grid::Grid> generate() = 0;
+
+    /**
+        @return the best distinct grids of the last generate() run, best
+        first. The first one is the grid generate() returned.
+     */
+    virtual std::vector<snapshot::GridSnapshot> get_results() const = 0;
+
+    /**
+        Rebuilds a grid of get_results() on a grid of the generator's dimensions.
+     */
+    virtual std::unique_ptr<grid::Grid> restore(snapshot::GridSnapshot const &result) const = 0;
+};
+
+/**
+    Generator scoring with the scorer policy ScorerPolicy, see
+    scoring::PolicyScorer. The restarts, the engine and the annealer call
+    the policy directly, so its scoring is inlined into them. Instantiated in
+    generator.cpp for every policy.
+ */
+template<typename ScorerPolicy>
+class BasicGenerator : public Generator
+{
 private:
     std::int_fast32_t PROGRESS_EVER_N_GRIDS = 50;
-    
-    std::default_random_engine m_rng;
 
-    std::int_fast32_t m_gen_count;
+    unsigned int m_rng_seed;
+
+    StopCriteria m_stop_criteria;
+    std::int_fast32_t m_thread_count;
     std::int_fast32_t m_cw_max_width;
     std::int_fast32_t m_cw_max_height;
+    // size of each of the worker's transposition tables, 0 disables them
+    std::size_t m_transposition_table_size;
+
+    WordStore word_list;
+    // Built once from word_list and shared by all workers. Only the index
+    // the engine uses is built, see Engine::picks_words(). The heuristics
+    // are built with the crossing index.
+    CrossingIndex m_crossings;
+    PatternIndex m_patterns;
+    search::Heuristics m_heuristics;
+    scoring::PolicyScorer<ScorerPolicy> m_grid_scorer;
+    std::unique_ptr<search::BasicEngine<ScorerPolicy> > m_engine;
+    search::Annealer m_annealer;
+    // number of words a grid is meant to hold, see Engine::get_word_count()
+    std::size_t m_word_count;
+
+    // state shared by all workers during generate()
+    std::chrono::steady_clock::time_point m_deadline;
+    // restarts end early enough to leave the annealing budget before m_deadline
+    std::chrono::steady_clock::time_point m_restart_deadline;
+    std::atomic<std::int_fast32_t> m_next_restart;
+    std::atomic<std::int_fast32_t> m_finished_restarts;
+    std::atomic<std::int_fast32_t> m_last_improvement;
+    // restarts that built a grid the worker had built before
+    std::atomic<std::int_fast32_t> m_duplicate_grids;
+    // restarts the engine abandoned, as they could not get into the result pool
+    std::atomic<std::int_fast32_t> m_abandoned_restarts;
+    std::atomic<scoring::score> m_highest_score;
+    // score a grid must beat to get into m_results, written under m_pool_mutex
+    std::atomic<scoring::score> m_pool_threshold;
+    std::atomic<StopReason> m_stop_reason;
+    std::mutex m_console_mutex;
+
+    SnapshotSettings m_snapshot_settings;
+    // Guards the members below. The pool writer and the random generators
+    // are only used if snapshots are enabled.
+    std::mutex m_pool_mutex;
+    std::unique_ptr<snapshot::PoolWriter> m_pool_writer;
+    // the best distinct grids of the run
+    snapshot::ResultPool m_results;
+    // random generator of every worker as after its last recorded restart
+    std::vector<std::default_random_engine> m_worker_rngs;
+    // finished restarts of the last checkpoint written, checkpoints never go back
+    std::int_fast32_t m_last_checkpoint = 0;
+
+    /**
+        Worker loop. Claims restarts until one of the stop criteria is met,
+        anneals the best grid this worker has generated and returns it together
+        with its score. The returned grid is nullptr if the worker did not get any restart.
+     */
+    std::pair<std::unique_ptr<grid::Grid>, scoring::score> run_worker(std::int_fast32_t worker_id);
+
+    /**
+        Checks the restart limit and the time budget before restart number
+        'restart' is started. The very first restart is always run, so that
+        a grid is available however small the budget is.
+     */
+    bool may_start_restart(std::int_fast32_t restart);
+
+    /**
+        Records the score of a finished restart, updates the shared best score
+        and checks the target score and stall criteria.
+     */
+    void record_score(std::int_fast32_t restart, scoring::score grid_score);
+
+    /**
+        Ends the run. Only the first reason passed is kept.
+     */
+    void request_stop(StopReason reason);
+
+    void report_progress(std::int_fast32_t finished_restarts);
+
+    /**
+        Seeds the workers' random generators, loads the last checkpoint if the
+        run is resumed and opens the pool file.
+     */
+    void open_pool();
 
-    WordList word_list;
-    std::unique_ptr<scoring::Scorer> m_grid_scorer;
+    /**
+        Counts a finished restart that was not abandoned and adds its grid to
+        the result pool if it is among the best ones. If snapshots are
+        enabled, writes a checkpoint once checkpoint_interval restarts
+        finished since the last one.
+        @return the number of finished restarts, this one included
+     */
+    std::int_fast32_t record_result(std::int_fast32_t worker_id, std::default_random_engine const &rng,
+                                    grid::Grid const &grid, scoring::score grid_score);
 
-    std::unique_ptr<grid::Grid> generate_single_grid();
+    // callers must hold m_pool_mutex
+    void add_to_pool(grid::Grid const &grid, scoring::score grid_score);
+    void write_checkpoint(std::int_fast32_t finished_restarts);
 public:
-    Generator(std::int_fast32_t number_of_crosswords_to_generated,
-              std::int_fast32_t crossword_max_width, std::int_fast32_t crossword_max_height,
-              std::unique_ptr<WordProvider> provider, std::unique_ptr<scoring::Scorer> grid_scorer);
+    BasicGenerator(StopCriteria const &stop_criteria, std::int_fast32_t thread_count,
+                   std::int_fast32_t crossword_max_width, std::int_fast32_t crossword_max_height,
+                   std::size_t transposition_table_size, SnapshotSettings const &snapshot_settings,
+                   search::HeuristicSettings const &heuristic_settings, std::unique_ptr<WordProvider> provider,
+                   ScorerPolicy const &scorer_policy, std::unique_ptr<search::BasicEngine<ScorerPolicy> > engine,
+                   search::Annealer const &annealer);
 
-    std::unique_ptr<grid::Grid> generate();
-};
\ No newline at end of file
+    std::unique_ptr<grid::Grid> generate() override;
+    std::vector<snapshot::GridSnapshot> get_results() const override;
+    std::unique_ptr<grid::Grid> restore(snapshot::GridSnapshot const &result) const override;
+};
@@ -1,26 +1,26 @@
 #include <algorithm>
+#include <cstdlib>
 #include <cstring>
 #include <iostream>
 #include <sstream>
 
 #include "grid.h"
+#include "segmentmatch.h"
 
-// convenience macros for grid access at its only a 1D array internallly
-#define GIDX(row, col) ((row) * m_internal_column_count + col)
+static_assert(WordStore::LETTER_PADDING >= grid::SEGMENT_MATCH_PADDING,
+              "segment_matches() reads past the end of a word's letters");
 
-// ATTENTION: These macros do not check for row/columns out-of-bounds!
-#define INC_ROW(gidx) (gidx += m_internal_column_count)
-#define INC_COLUMN(gidx) (++gidx)
+// bit of a window slot within a bitboard line, see Grid::m_row_bits
+#define LINE_BIT(slot) ((slot) + 1)
+#define WORD_BITS 64
 
-#define UP_CELL(gidx) (gidx - m_internal_column_count)
-#define DOWN_CELL(gidx) (gidx + m_internal_column_count)
-#define LEFT_CELL(gidx) (gidx - 1)
-#define RIGHT_CELL(gidx) (gidx + 1)
+// Factors of the row and column of a word in its hash term. They are odd,
+// so that they have an inverse modulo 2^64.
+#define HASH_ROW_FACTOR 0x9E3779B97F4A7C15ULL
+#define HASH_COLUMN_FACTOR 0xC2B2AE3D27D4EB4FULL
 
 using namespace grid;
 
-char const Grid::EMPTY_CHAR = '.';
-
 bool Location::operator<(Location const &other) const
 {
     if (row == other.row && column == other.column)
@@ -34,168 +34,942 @@ bool Location::operator<(Location const &other) const
     return row < other.row;
 }
 
-Grid::Grid(gidx max_row_count, gidx max_column_count) :
-    m_internal_row_count(2 * max_row_count), m_internal_column_count(2 * max_column_count),
-    m_crossing_count(0),
-    m_max_row_count(max_row_count), m_max_column_count(max_column_count),
-    // First word will be placed in the center of the internal grid.
-    // This is the passed row/column count, as row/column count is doubled internally
-    // to allow flexible placements of words in all directions
-    m_min_row_used(max_row_count), m_max_row_used(max_row_count),
-    m_min_column_used(max_column_count), m_max_column_used(max_column_count)
+bool Location::operator==(Location const &other) const
 {
-    // Internally, we keep a grid of double given the column and row size.
-    // That way, we can simply place the first word in the middle of the grid
-    // and still have space in all directions. Thus, we do not restrict possible
-    // solutions due to unfortunate placements of the first word.
-    gidx gridsize = max_row_count * 2 * max_column_count * 2;
-    m_grid = std::make_unique<char[]>(gridsize);
-    std::fill(m_grid.get(), m_grid.get() + gridsize, EMPTY_CHAR);
+    return row == other.row && column == other.column && direction == other.direction;
 }
 
-bool Grid::is_in_bounds(Word const &word, Location const &loc) const
+static inline bool test_bit(std::uint64_t const *line, gidx bit)
 {
-    gidx start_row = loc.row;
-    gidx start_col = loc.column;
-    // Hack to avoid branching. Assumes that vertical = 0, horizontal = 1
-    gidx end_row = loc.row + (word.length - 1) * (1 - loc.direction);
-    gidx end_col = loc.column + (word.length - 1) * loc.direction;
+    return (line[bit / WORD_BITS] >> (bit % WORD_BITS)) & 1;
+}
 
-    bool out_of_bounds = start_row < 0 || end_row >= m_internal_row_count;
-    out_of_bounds |= start_col < 0 || end_col >= m_internal_column_count;
-    out_of_bounds |= std::max(end_col, m_max_column_used) - std::min(start_col, m_min_column_used)
-                     >= m_max_column_count;
-    out_of_bounds |= std::max(end_row, m_max_row_used) - std::min(start_row, m_min_row_used)
-                     >= m_max_row_count;
+static inline void assign_bit(std::uint64_t *line, gidx bit, bool value)
+{
+    std::uint64_t const mask = std::uint64_t(1) << (bit % WORD_BITS);
+    line[bit / WORD_BITS] = (line[bit / WORD_BITS] & ~mask) | (-std::uint64_t(value) & mask);
+}
 
-    return !out_of_bounds;
+// sets the bit of a slot at all of its positions in a line of a window of size width
+static inline void assign_slot(std::uint64_t *line, gidx slot, gidx width, bool value)
+{
+    assign_bit(line, LINE_BIT(slot), value);
+    assign_bit(line, LINE_BIT(slot + width), value);
+    if (slot == width - 1)
+        assign_bit(line, LINE_BIT(-1), value);
+    if (slot == 0)
+        assign_bit(line, LINE_BIT(2 * width), value);
 }
 
-bool Grid::is_valid_placement(Word const &word, Location const &loc) const
+static inline gidx next_slot(gidx slot, gidx width)
 {
-    if (!is_in_bounds(word, loc))
-        return false;
+    return slot + 1 == width ? 0 : slot + 1;
+}
 
-    gidx start_row = loc.row;
-    gidx start_col = loc.column;
-    // Hack to avoid branching. Assumes that vertical = 0, horizontal = 1
-    gidx end_row = loc.row + (word.length - 1) * (1 - loc.direction);
-    gidx end_col = loc.column + (word.length - 1) * loc.direction;
+static inline gidx previous_slot(gidx slot, gidx width)
+{
+    return slot == 0 ? width - 1 : slot - 1;
+}
 
-    gidx cell = GIDX(start_row, start_col);
-    bool conflict = false;
-    switch (loc.direction)
+// Length of the run of free cells (not set in any of the three lines) ending
+// right before bit pos, at most limit. 'letter' tells if the run ends at a bit
+// set in 'line', i.e. at an occupied cell of the line itself.
+static gidx free_run_before(std::uint64_t const *line, std::uint64_t const *side1, std::uint64_t const *side2,
+                            gidx pos, gidx limit, bool &letter)
+{
+    letter = false;
+    gidx reach = 0;
+    for (gidx p = pos - 1; p >= 0 && reach < limit;)
     {
-    case Direction::HORIZONTAL:
-        // check cells before and after the word
-        conflict |= start_col > 0 && m_grid[LEFT_CELL(cell)] != EMPTY_CHAR;
-        conflict |= end_col + 1 < m_internal_column_count
-                    && m_grid[RIGHT_CELL(GIDX(end_row, end_col))] != EMPTY_CHAR;
+        gidx const w = p / WORD_BITS, b = p % WORD_BITS;
+        // bits up to p, with p moved to the highest bit
+        std::uint64_t const blocked = (line[w] | side1[w] | side2[w]) << (WORD_BITS - 1 - b);
+        if (blocked != 0)
+        {
+            gidx const distance = __builtin_clzll(blocked);
+            if (reach + distance >= limit)
+                return limit;
+            letter = test_bit(line, p - distance);
+            return reach + distance;
+        }
+        reach += b + 1;
+        p -= b + 1;
+    }
+    return std::min(reach, limit);
+}
+
+// Same as free_run_before(), for the run starting right after bit pos
+static gidx free_run_after(std::uint64_t const *line, std::uint64_t const *side1, std::uint64_t const *side2,
+                           gidx pos, gidx limit, bool &letter)
+{
+    letter = false;
+    gidx reach = 0;
+    for (gidx p = pos + 1; reach < limit;)
+    {
+        gidx const w = p / WORD_BITS, b = p % WORD_BITS;
+        // bits from p on, with p moved to the lowest bit
+        std::uint64_t const blocked = (line[w] | side1[w] | side2[w]) >> b;
+        if (blocked != 0)
+        {
+            gidx const distance = __builtin_ctzll(blocked);
+            if (reach + distance >= limit)
+                return limit;
+            letter = test_bit(line, p + distance);
+            return reach + distance;
+        }
+        reach += WORD_BITS - b;
+        p += WORD_BITS - b;
+    }
+    return limit;
+}
+
+// Calls f(bit) for every bit set in [first, last] of line
+template<typename F>
+static inline void for_each_set_bit(std::uint64_t const *line, gidx first, gidx last, F f)
+{
+    for (gidx w = first / WORD_BITS; w <= last / WORD_BITS; w++)
+    {
+        gidx const lo = std::max(first, w * WORD_BITS) - w * WORD_BITS;
+        gidx const hi = std::min(last, w * WORD_BITS + WORD_BITS - 1) - w * WORD_BITS;
+        std::uint64_t bits = line[w] & (~std::uint64_t(0) << lo) & (~std::uint64_t(0) >> (WORD_BITS - 1 - hi));
+        for (; bits != 0; bits &= bits - 1)
+        {
+            f(w * WORD_BITS + __builtin_ctzll(bits));
+        }
+    }
+}
+
+// inverse of an odd number modulo 2^64, by Newton's iteration
+static std::uint64_t inverse_of(std::uint64_t odd)
+{
+    // odd * odd = 1 modulo 8, every step doubles the number of correct bits
+    std::uint64_t inverse = odd;
+    for (int i = 0; i < 5; i++)
+    {
+        inverse *= 2 - odd * inverse;
+    }
+    return inverse;
+}
+
+// 64 bits of a line from bit 'bit' on. Lines end with a spare word, so this
+// may read past the last bit a line holds.
+static inline std::uint64_t read_bits(std::uint64_t const *line, gidx bit)
+{
+    gidx const w = bit / WORD_BITS, b = bit % WORD_BITS;
+    return b == 0 ? line[w] : (line[w] >> b) | (line[w + 1] << (WORD_BITS - b));
+}
 
-        for (auto c = 0; c < word.length; c++)
+// Longest run of set bits in 'bits', where 'run' is the length of the run
+// ending right before them. 'run' is updated to the run ending at their last bit.
+static inline gidx longest_run(std::uint64_t bits, gidx &run)
+{
+    gidx longest = run;
+    for (gidx pos = 0; pos < WORD_BITS;)
+    {
+        std::uint64_t const rest = bits >> pos;
+        if ((rest & 1) == 0)
         {
-            if (m_grid[cell] == EMPTY_CHAR)
+            run = 0;
+            if (rest == 0)
+                break;
+            pos += __builtin_ctzll(rest);
+            continue;
+        }
+        gidx const ones = ~rest == 0 ? WORD_BITS : std::min<gidx>(__builtin_ctzll(~rest), WORD_BITS - pos);
+        run += ones;
+        pos += ones;
+        longest = std::max(longest, run);
+    }
+    return longest;
+}
+
+// root of a run in the union-find forest of get_layout_metrics(), halving the path on the way
+static inline std::size_t find_root(std::vector<std::size_t> &parents, std::size_t run)
+{
+    while (parents[run] != run)
+    {
+        parents[run] = parents[parents[run]];
+        run = parents[run];
+    }
+    return run;
+}
+
+namespace
+{
+
+// dimensions only known at runtime, read from the grid's geometry
+struct RuntimeDimensions
+{
+    static constexpr bool FIXED = false;
+};
+
+// dimensions known at compile time, with power-of-two strides
+template<gidx MaxRows, gidx MaxColumns>
+struct FixedDimensions
+{
+    static constexpr bool FIXED = true;
+    static constexpr GridGeometry GEOMETRY = GridGeometry::of(MaxRows, MaxColumns, true);
+};
+
+} // namespace
+
+template<typename Dimensions>
+struct Grid::Kernels
+{
+    // bitboard lines and cells of a window row/column, see window_line()
+    typedef struct WindowLine
+    {
+        std::uint64_t const *bits, *before, *after;
+        char const *cells;
+        gidx width;
+        // longest free run that matters for a cross-check
+        gidx limit;
+    } WindowLine;
+
+    static GridGeometry const & geometry(Grid const &grid)
+    {
+        if constexpr (Dimensions::FIXED)
+            return Dimensions::GEOMETRY;
+        else
+            return grid.m_geometry;
+    }
+
+    static gidx row_slot(Grid const &grid, gidx row)
+    {
+        if constexpr (Dimensions::FIXED)
+            return (row + Dimensions::GEOMETRY.window_rows) % Dimensions::GEOMETRY.window_rows;
+        else
+            return grid.m_row_slots[row + 1];
+    }
+
+    static gidx column_slot(Grid const &grid, gidx column)
+    {
+        if constexpr (Dimensions::FIXED)
+            return (column + Dimensions::GEOMETRY.window_columns) % Dimensions::GEOMETRY.window_columns;
+        else
+            return grid.m_column_slots[column + 1];
+    }
+
+    // index of a cell in the window m_grid, also used by the cross-checks and anchors
+    static gidx cell(Grid const &grid, gidx row_slot, gidx column_slot)
+    {
+        return row_slot * geometry(grid).row_stride + column_slot;
+    }
+
+    // index of a cell in the transposed window
+    static gidx transposed_cell(Grid const &grid, gidx row_slot, gidx column_slot)
+    {
+        return column_slot * geometry(grid).column_stride + row_slot;
+    }
+
+    static std::uint64_t * row_bits(Grid const &grid, gidx slot)
+    {
+        return &grid.m_row_bits[slot * geometry(grid).row_line_words];
+    }
+
+    static std::uint64_t * column_bits(Grid const &grid, gidx slot)
+    {
+        return &grid.m_column_bits[slot * geometry(grid).column_line_words];
+    }
+
+    static std::uint64_t * row_line(Grid const &grid, gidx row)
+    {
+        return row_bits(grid, row_slot(grid, row));
+    }
+
+    static std::uint64_t * column_line(Grid const &grid, gidx column)
+    {
+        return column_bits(grid, column_slot(grid, column));
+    }
+
+    static CrossCheck & cross_check(Grid const &grid, gidx row_slot, gidx column_slot, Direction dir)
+    {
+        return grid.m_cross_checks[2 * cell(grid, row_slot, column_slot) + dir];
+    }
+
+    static void set_occupied(Grid &grid, gidx row_slot, gidx column_slot, bool occupied)
+    {
+        assign_slot(row_bits(grid, row_slot), column_slot, geometry(grid).window_columns, occupied);
+        assign_slot(column_bits(grid, column_slot), row_slot, geometry(grid).window_rows, occupied);
+    }
+
+    static bool is_occupied(Grid const &grid, gidx row_slot, gidx column_slot)
+    {
+        return test_bit(row_bits(grid, row_slot), LINE_BIT(column_slot));
+    }
+
+    /**
+        Checks if the cell at the internal row and column is also used by a
+        word in the other direction than dir. Without a neighbour across dir
+        it is not. A neighbour alone is not enough though: once words are
+        removed in any order, it may be the end of a word parallel to dir that
+        a removed word connected to the cell. So the word through the cell is
+        looked up among the placed words.
+     */
+    static bool is_crossing_cell(Grid const &grid, gidx row, gidx column, Direction dir)
+    {
+        GridGeometry const &geo = geometry(grid);
+        gidx const rs = row_slot(grid, row), cs = column_slot(grid, column);
+        bool const horizontal = dir == Direction::HORIZONTAL;
+        bool const neighbour = horizontal
+                               ? is_occupied(grid, previous_slot(rs, geo.window_rows), cs)
+                                 || is_occupied(grid, next_slot(rs, geo.window_rows), cs)
+                               : is_occupied(grid, rs, previous_slot(cs, geo.window_columns))
+                                 || is_occupied(grid, rs, next_slot(cs, geo.window_columns));
+        if (!neighbour)
+            return false;
+
+        // The crossing word starts within the run of occupied cells ending at
+        // the cell. Words with the same direction never touch, so the first
+        // word found in the run is the only candidate.
+        Direction const across = horizontal ? Direction::VERTICAL : Direction::HORIZONTAL;
+        for (gidx offset = 0;; offset++)
+        {
+            gidx const r = horizontal ? row - offset : row;
+            gidx const c = horizontal ? column : column - offset;
+            if (!is_occupied(grid, row_slot(grid, r), column_slot(grid, c)))
+                return false;
+            auto const it = grid.m_words.find({ r, c, across });
+            if (it != grid.m_words.end())
+                return grid.m_word_store->length(it->second) > offset;
+        }
+    }
+
+    static WindowLine window_line(Grid const &grid, Direction dir, gidx slot)
+    {
+        GridGeometry const &geo = geometry(grid);
+        // the lines next to the window's first/last line are its last/first line
+        switch (dir)
+        {
+        case Direction::HORIZONTAL:
+            return { row_bits(grid, slot),
+                     row_bits(grid, previous_slot(slot, geo.window_rows)),
+                     row_bits(grid, next_slot(slot, geo.window_rows)),
+                     &grid.m_grid[slot * geo.row_stride], geo.window_columns,
+                     std::min<gidx>(grid.m_word_store->max_length(), geo.max_columns) };
+        case Direction::VERTICAL:
+        default:
+            return { column_bits(grid, slot),
+                     column_bits(grid, previous_slot(slot, geo.window_columns)),
+                     column_bits(grid, next_slot(slot, geo.window_columns)),
+                     &grid.m_grid_transposed[slot * geo.column_stride], geo.window_rows,
+                     std::min<gidx>(grid.m_word_store->max_length(), geo.max_rows) };
+        }
+    }
+
+    static void compute_cross_check(WindowLine const &line, gidx slot, CrossCheck &check)
+    {
+        // No need to look further than a word can be long. Runs are scanned in
+        // the copy of the window that leaves room before/after the slot.
+        bool letter;
+        check.reach_before = free_run_before(line.bits, line.before, line.after,
+                                             LINE_BIT(slot + line.width), line.limit, letter);
+        check.stop_before = letter ? line.cells[(slot - check.reach_before - 1 + line.width) % line.width]
+                                   : EMPTY_CHAR;
+        check.reach_after = free_run_after(line.bits, line.before, line.after, LINE_BIT(slot), line.limit, letter);
+        check.stop_after = letter ? line.cells[(slot + check.reach_after + 1) % line.width] : EMPTY_CHAR;
+    }
+
+    /**
+        Recomputes the cross-checks of the occupied cells whose free runs reach
+        the cells of a word that was placed or removed. These are the cells of
+        the word's line and the lines next to it, and the closest occupied cell
+        in each direction from there.
+     */
+    static void update_cross_checks(Grid const &grid, Word const &word, Location const &loc)
+    {
+        GridGeometry const &geo = geometry(grid);
+        // the word covers 'length' slots from slot 'first' of window line 'index'
+        Direction const along = loc.direction;
+        Direction const across = along == Direction::HORIZONTAL ? Direction::VERTICAL : Direction::HORIZONTAL;
+        gidx const index = along == Direction::HORIZONTAL ? row_slot(grid, loc.row) : column_slot(grid, loc.column);
+        gidx const first = along == Direction::HORIZONTAL ? column_slot(grid, loc.column) : row_slot(grid, loc.row);
+        gidx const length = word.length;
+
+        auto const update = [&grid](WindowLine const &line, Direction dir, gidx line_slot, gidx slot) {
+            slot %= line.width;
+            CrossCheck &check = dir == Direction::HORIZONTAL ? cross_check(grid, line_slot, slot, dir)
+                                                             : cross_check(grid, slot, line_slot, dir);
+            compute_cross_check(line, slot, check);
+        };
+        // A free run reaching into the slots [from, from + count) of a line from
+        // outside ends at the first cell blocked by the line or its neighbours.
+        // Only if that is an occupied cell close enough, it has a cross-check to update.
+        auto const update_outside = [&update](WindowLine const &line, Direction dir, gidx line_slot,
+                                              gidx from, gidx count) {
+            bool letter;
+            gidx reach = free_run_before(line.bits, line.before, line.after, LINE_BIT(from + line.width),
+                                         line.limit + 1, letter);
+            if (letter)
+                update(line, dir, line_slot, from - reach - 1 + line.width);
+            gidx const last = (from + count - 1) % line.width;
+            reach = free_run_after(line.bits, line.before, line.after, LINE_BIT(last), line.limit + 1, letter);
+            if (letter)
+                update(line, dir, line_slot, last + reach + 1);
+        };
+
+        // The changed cells are neighbours for the lines across the word next to them.
+        gidx const across_count = across == Direction::HORIZONTAL ? geo.window_rows : geo.window_columns;
+        for (gidx i = 0; i < length + 2; i++)
+        {
+            gidx const slot = (first - 1 + i + across_count) % across_count;
+            WindowLine const line = window_line(grid, across, slot);
+            if (test_bit(line.bits, LINE_BIT(index)))
+                update(line, across, slot, index);
+            update_outside(line, across, slot, index, 1);
+        }
+
+        // Along the word, its own line and the two next to it changed.
+        gidx const along_count = along == Direction::HORIZONTAL ? geo.window_rows : geo.window_columns;
+        for (gidx i = -1; i <= 1; i++)
+        {
+            gidx const slot = (index + i + along_count) % along_count;
+            WindowLine const line = window_line(grid, along, slot);
+            for_each_set_bit(line.bits, LINE_BIT(first), LINE_BIT(first + length - 1), [&](gidx bit) {
+                update(line, along, slot, bit - LINE_BIT(0));
+            });
+            update_outside(line, along, slot, first, length);
+        }
+    }
+
+    static bool is_in_bounds(Grid const &grid, Word const &word, Location const &loc)
+    {
+        GridGeometry const &geo = geometry(grid);
+        gidx start_row = loc.row;
+        gidx start_col = loc.column;
+        // Hack to avoid branching. Assumes that vertical = 0, horizontal = 1
+        gidx end_row = loc.row + (word.length - 1) * (1 - loc.direction);
+        gidx end_col = loc.column + (word.length - 1) * loc.direction;
+
+        bool out_of_bounds = start_row < 0 || end_row >= geo.internal_rows;
+        out_of_bounds |= start_col < 0 || end_col >= geo.internal_columns;
+        out_of_bounds |= std::max(end_col, grid.m_max_column_used) - std::min(start_col, grid.m_min_column_used)
+                         >= geo.max_columns;
+        out_of_bounds |= std::max(end_row, grid.m_max_row_used) - std::min(start_row, grid.m_min_row_used)
+                         >= geo.max_rows;
+
+        return !out_of_bounds;
+    }
+
+    static bool is_valid_placement(Grid const &grid, Word const &word, Location const &loc)
+    {
+        if (!is_in_bounds(grid, word, loc))
+            return false;
+
+        // The rules are checked on the bitboard lines of the word and of its two
+        // neighbouring lines, 64 cells at a time. The letters are then compared
+        // against the word's cells, which are contiguous in either m_grid or
+        // m_grid_transposed, unless they wrap around the end of the window.
+        GridGeometry const &geo = geometry(grid);
+        std::uint64_t const *line, *before, *after;
+        char const *cells;
+        gidx slot, width;
+        switch (loc.direction)
+        {
+        case Direction::HORIZONTAL:
+            line = row_line(grid, loc.row);
+            before = row_line(grid, loc.row - 1);
+            after = row_line(grid, loc.row + 1);
+            cells = &grid.m_grid[row_slot(grid, loc.row) * geo.row_stride];
+            slot = column_slot(grid, loc.column);
+            width = geo.window_columns;
+            break;
+        case Direction::VERTICAL:
+        default:
+            line = column_line(grid, loc.column);
+            before = column_line(grid, loc.column - 1);
+            after = column_line(grid, loc.column + 1);
+            cells = &grid.m_grid_transposed[column_slot(grid, loc.column) * geo.column_stride];
+            slot = row_slot(grid, loc.row);
+            width = geo.window_rows;
+            break;
+        }
+        gidx const first = LINE_BIT(slot);
+        gidx const last = first + word.length - 1;
+
+        // cells before and after the word must be empty
+        if (test_bit(line, first - 1) || test_bit(line, last + 1))
+            return false;
+
+        for (gidx w = first / WORD_BITS; w <= last / WORD_BITS; w++)
+        {
+            // bits of the word's cells within line word w
+            gidx const lo = std::max(first, w * WORD_BITS) - w * WORD_BITS;
+            gidx const hi = std::min(last, w * WORD_BITS + WORD_BITS - 1) - w * WORD_BITS;
+            std::uint64_t const mask = (~std::uint64_t(0) << lo) & (~std::uint64_t(0) >> (WORD_BITS - 1 - hi));
+
+            std::uint64_t const occupied = line[w];
+            // an empty cell of the word must not have neighbours across the word
+            std::uint64_t conflicts = (before[w] | after[w]) & ~occupied;
+            // Two occupied cells next to each other mean that the word would overlap
+            // a word with the same orientation. Like "testtest" on "testt"
+            conflicts |= occupied & ((occupied >> 1) | (line[w + 1] << (WORD_BITS - 1)));
+            if (conflicts & mask)
+                return false;
+        }
+
+        // at the crossings, the letters have to match
+        gidx const head = std::min<gidx>(word.length, width - slot);
+        return segment_matches(cells + slot, word.word.data(), head, EMPTY_CHAR)
+               && (head == word.length
+                   || segment_matches(cells, word.word.data() + head, word.length - head, EMPTY_CHAR));
+    }
+
+    // Writes the letters of the word and updates the counts and anchors.
+    static void place_word_unchecked(Grid &grid, Word const &word, Location const &loc)
+    {
+        GridGeometry const &geo = geometry(grid);
+        bool const horizontal = loc.direction == Direction::HORIZONTAL;
+        gidx rs = row_slot(grid, loc.row), cs = column_slot(grid, loc.column);
+        for (auto i = 0; i < word.length; i++)
+        {
+            gidx const c = cell(grid, rs, cs);
+            if (grid.m_grid[c] != EMPTY_CHAR)
             {
-                // if this cell is empty, the one above and below musst be empty as well
-                if (start_row > 0)
-                    conflict |= m_grid[UP_CELL(cell)] != EMPTY_CHAR;
-                if (start_row + 1 < m_internal_row_count)
-                    conflict |= m_grid[DOWN_CELL(cell)] != EMPTY_CHAR;
+                grid.m_crossing_count++;
+                grid.remove_anchor(word[i], c);
             }
             else
             {
-                // As this cell is not empty, it must be the same value as the
-                // letter of the word that we want to place here.
-                conflict |= m_grid[cell] != word[c];
-
-                // If we have a valid crossing here, the next character must be free!
-                // If this is not the case, this means there is already another word
-                // placed here with the same orientation. Needed to prevent placing a
-                // word on a word with overlapping suffix/prefix. Like "testtest" on "testt"
-                conflict |= m_grid[cell] == word[c] && m_grid[RIGHT_CELL(cell)] != EMPTY_CHAR;
+                grid.m_letter_count++;
+                grid.add_anchor(word[i], c);
+                set_occupied(grid, rs, cs, true);
             }
 
-            INC_COLUMN(cell); // afterwards as we have to check letter 0 as well
+            grid.m_grid[c] = word[i];
+            grid.m_grid_transposed[transposed_cell(grid, rs, cs)] = word[i];
+            rs = horizontal ? rs : next_slot(rs, geo.window_rows);
+            cs = horizontal ? next_slot(cs, geo.window_columns) : cs;
         }
-        break;
-    case Direction::VERTICAL:
-        // check cells above and below the word
-        conflict |= start_row > 0 && m_grid[UP_CELL(cell)] != EMPTY_CHAR;
-        conflict |= end_row + 1 < m_internal_row_count
-                    && m_grid[DOWN_CELL(GIDX(end_row, end_col))] != EMPTY_CHAR;
+    }
 
-        for (auto c = 0; c < word.length; c++)
+    // Clears the cells of a placed word that are not shared with crossing words.
+    static void clear_word_cells(Grid &grid, Word const &word, Location const &loc)
+    {
+        GridGeometry const &geo = geometry(grid);
+        bool const horizontal = loc.direction == Direction::HORIZONTAL;
+        gidx rs = row_slot(grid, loc.row), cs = column_slot(grid, loc.column);
+        for (auto i = 0; i < word.length; i++)
         {
-            if (m_grid[cell] == EMPTY_CHAR)
+            gidx const c = cell(grid, rs, cs);
+            if (is_crossing_cell(grid, loc.row + (horizontal ? 0 : i), loc.column + (horizontal ? i : 0),
+                                 loc.direction))
             {
-                // if this cell is empty, the one left and right musst be empty as well
-                if (start_col > 0)
-                    conflict |= m_grid[LEFT_CELL(cell)] != EMPTY_CHAR;
-                if (start_col + 1 < m_internal_column_count)
-                    conflict |= m_grid[RIGHT_CELL(cell)] != EMPTY_CHAR;
+                // only one word left in this cell, so it can be crossed again
+                grid.m_crossing_count--;
+                grid.add_anchor(word[i], c);
             }
             else
             {
-                // As this cell is not empty, it must be the same value as the
-                // letter of the word that we want to place here.
-                conflict |= m_grid[cell] != word[c];
-
-                // If we have a valid crossing here, the next character must be free!
-                // If this is not the case, this means there is already another word
-                // placed here with the same orientation. Needed to prevent placing a
-                // word on a word with overlapping suffix/prefix. Like "testtest" on "testt"
-                conflict |= m_grid[cell] == word[c] && m_grid[DOWN_CELL(cell)] != EMPTY_CHAR;
+                grid.m_letter_count--;
+                grid.remove_anchor(word[i], c);
+                grid.m_grid[c] = EMPTY_CHAR;
+                grid.m_grid_transposed[transposed_cell(grid, rs, cs)] = EMPTY_CHAR;
+                set_occupied(grid, rs, cs, false);
             }
+            rs = horizontal ? rs : next_slot(rs, geo.window_rows);
+            cs = horizontal ? next_slot(cs, geo.window_columns) : cs;
+        }
+    }
+
+    // The internal row and column of an anchor cell, which are the ones within the used bounds.
+    static std::pair<gidx, gidx> anchor_position(Grid const &grid, gidx anchor)
+    {
+        GridGeometry const &geo = geometry(grid);
+        return { grid.m_min_row_used + (anchor / geo.row_stride - row_slot(grid, grid.m_min_row_used)
+                                        + geo.window_rows) % geo.window_rows,
+                 grid.m_min_column_used + (anchor % geo.row_stride - column_slot(grid, grid.m_min_column_used)
+                                           + geo.window_columns) % geo.window_columns };
+    }
 
-            INC_ROW(cell);
+    static void get_valid_placements(Grid const &grid, Word const &word, std::vector<grid::Location> &buffer)
+    {
+        for (auto cidx = 0; cidx < word.length; cidx++)
+        {
+            gidx const after = word.length - 1 - cidx;
+            // linear scan over all cells holding this letter
+            for (gidx const anchor : grid.m_anchors[static_cast<unsigned char>(word[cidx])])
+            {
+                for (Direction const dir : { Direction::VERTICAL, Direction::HORIZONTAL })
+                {
+                    // Decide from the cross-check where possible: A word within the
+                    // free runs around the anchor is valid. Its end may touch the end
+                    // of a run, but not a letter, and it may only run past the end of
+                    // a run through a letter it shares. Only such crossings of
+                    // further words need the full check.
+                    CrossCheck const &check = grid.m_cross_checks[2 * anchor + dir];
+                    bool full_check = false;
+                    if (cidx > check.reach_before)
+                    {
+                        if (word[cidx - check.reach_before - 1] != check.stop_before)
+                            continue;
+                        full_check = true;
+                    }
+                    else if (cidx == check.reach_before && check.stop_before != EMPTY_CHAR)
+                    {
+                        continue;
+                    }
+                    if (after > check.reach_after)
+                    {
+                        if (word[cidx + check.reach_after + 1] != check.stop_after)
+                            continue;
+                        full_check = true;
+                    }
+                    else if (after == check.reach_after && check.stop_after != EMPTY_CHAR)
+                    {
+                        continue;
+                    }
+
+                    auto const [row, col] = anchor_position(grid, anchor);
+                    Location const loc = dir == Direction::VERTICAL ? Location{row - cidx, col, dir}
+                                                                    : Location{row, col - cidx, dir};
+                    if (full_check ? is_valid_placement(grid, word, loc) : is_in_bounds(grid, word, loc))
+                    {
+                        buffer.push_back(loc);
+                    }
+                }
+            }
         }
-        break;
     }
-    return !conflict;
+
+    /**
+        Sweeps the rows of the used bounds, 64 cells of a row at a time. The
+        bits of a row are read at the used bounds' first column and one column
+        before and after it, which gives the left and right neighbour of every
+        cell without shifting. Runs along the columns are followed through the
+        rows by the row they started in.
+     */
+    static void get_layout_metrics(Grid const &grid, LayoutMetrics &metrics)
+    {
+        gidx const height = grid.get_height(), width = grid.get_width();
+        gidx const words = (width + WORD_BITS - 1) / WORD_BITS;
+        gidx const first = LINE_BIT(column_slot(grid, grid.m_min_column_used));
+        std::uint64_t const last_mask = ~std::uint64_t(0) >> (words * WORD_BITS - width);
+        std::int_fast32_t const letters = grid.m_letter_count;
+
+        // cells of the previous row in a column word but no row word
+        std::vector<std::uint64_t> &uncrossed_above = grid.m_metric_lines;
+        uncrossed_above.assign(words, 0);
+        // per column, the row its current uncrossed run started in
+        std::vector<std::int_fast32_t> &columns = grid.m_metric_columns;
+        columns.assign(width, 0);
+        std::vector<std::pair<gidx, gidx> > &runs = grid.m_metric_runs;
+        std::vector<std::size_t> &parents = grid.m_metric_parents;
+        runs.clear();
+        parents.clear();
+
+        std::int_fast32_t longest = 0, merges = 0, row_deviation = 0, column_deviation = 0;
+        std::size_t previous_runs = 0;
+        for (gidx r = 0; r < height; r++)
+        {
+            gidx const row = grid.m_min_row_used + r;
+            std::uint64_t const *line = row_line(grid, row);
+            std::uint64_t const *above = row_line(grid, row - 1);
+            std::uint64_t const *below = row_line(grid, row + 1);
+            std::size_t const row_runs = runs.size();
+            std::size_t ending_run = row_runs;
+            std::int_fast32_t row_letters = 0;
+            gidx run = 0;
+            for (gidx w = 0; w < words; w++)
+            {
+                gidx const bit = first + w * WORD_BITS, base = w * WORD_BITS;
+                std::uint64_t const cells = read_bits(line, bit) & (w + 1 == words ? last_mask : ~std::uint64_t(0));
+                std::uint64_t const left = read_bits(line, bit - 1), right = read_bits(line, bit + 1);
+                std::uint64_t const up = read_bits(above, bit), down = read_bits(below, bit);
+                // cells in a word along the row/along the column
+                std::uint64_t const in_row_word = cells & (left | right);
+                std::uint64_t const in_column_word = cells & (up | down);
+                std::uint64_t const uncrossed = in_column_word & ~in_row_word;
+
+                row_letters += __builtin_popcountll(cells);
+                longest = std::max<std::int_fast32_t>(longest, longest_run(in_row_word & ~in_column_word, run));
+
+                for (std::uint64_t b = cells & ~left; b != 0; b &= b - 1)
+                {
+                    parents.push_back(runs.size());
+                    runs.emplace_back(base + __builtin_ctzll(b), 0);
+                }
+                for (std::uint64_t b = cells & ~right; b != 0; b &= b - 1)
+                {
+                    runs[ending_run++].second = base + __builtin_ctzll(b);
+                }
+                for (std::uint64_t b = uncrossed & ~uncrossed_above[w]; b != 0; b &= b - 1)
+                {
+                    columns[base + __builtin_ctzll(b)] = r;
+                }
+                for (std::uint64_t b = uncrossed_above[w] & ~uncrossed; b != 0; b &= b - 1)
+                {
+                    longest = std::max(longest, r - columns[base + __builtin_ctzll(b)]);
+                }
+                uncrossed_above[w] = uncrossed;
+            }
+            row_deviation += std::abs(height * row_letters - letters);
+
+            // runs sharing a column with a run of the row above are on the same island
+            for (std::size_t i = previous_runs, j = row_runs; i < row_runs && j < runs.size();)
+            {
+                if (runs[i].first <= runs[j].second && runs[j].first <= runs[i].second)
+                {
+                    std::size_t const root_i = find_root(parents, i), root_j = find_root(parents, j);
+                    if (root_i != root_j)
+                    {
+                        parents[std::max(root_i, root_j)] = std::min(root_i, root_j);
+                        merges++;
+                    }
+                }
+                if (runs[i].second < runs[j].second)
+                    i++;
+                else
+                    j++;
+            }
+            previous_runs = row_runs;
+        }
+        // uncrossed runs along the columns reaching the last row
+        for (gidx w = 0; w < words; w++)
+        {
+            for (std::uint64_t b = uncrossed_above[w]; b != 0; b &= b - 1)
+            {
+                longest = std::max(longest, height - columns[w * WORD_BITS + __builtin_ctzll(b)]);
+            }
+        }
+        // the letters per column are counted on the column bitboards
+        gidx const first_row = LINE_BIT(row_slot(grid, grid.m_min_row_used));
+        gidx const row_words = (height + WORD_BITS - 1) / WORD_BITS;
+        std::uint64_t const last_row_mask = ~std::uint64_t(0) >> (row_words * WORD_BITS - height);
+        for (gidx c = 0; c < width; c++)
+        {
+            std::uint64_t const *line = column_line(grid, grid.m_min_column_used + c);
+            std::int_fast32_t column_letters = 0;
+            for (gidx w = 0; w < row_words; w++)
+            {
+                column_letters += __builtin_popcountll(read_bits(line, first_row + w * WORD_BITS)
+                                                       & (w + 1 == row_words ? last_row_mask : ~std::uint64_t(0)));
+            }
+            column_deviation += std::abs(width * column_letters - letters);
+        }
+
+        metrics.letter_count = letters;
+        metrics.area = height * width;
+        metrics.island_count = runs.size() - merges;
+        metrics.longest_uncrossed_run = longest;
+        metrics.row_imbalance = row_deviation / height;
+        metrics.column_imbalance = column_deviation / width;
+    }
+
+    static KernelTable const TABLE;
+};
+
+template<typename Dimensions>
+Grid::KernelTable const Grid::Kernels<Dimensions>::TABLE = {
+    Dimensions::FIXED,
+    &Kernels::is_in_bounds,
+    &Kernels::is_valid_placement,
+    &Kernels::place_word_unchecked,
+    &Kernels::clear_word_cells,
+    &Kernels::update_cross_checks,
+    &Kernels::get_valid_placements,
+    &Kernels::get_layout_metrics
+};
+
+Grid::KernelTable const * Grid::select_kernels(gidx max_row_count, gidx max_column_count)
+{
+    // the A4 page of the default config and common newspaper sizes
+    if (max_row_count == 60 && max_column_count == 40)
+        return &Kernels<FixedDimensions<60, 40>>::TABLE;
+    if (max_row_count == 15 && max_column_count == 15)
+        return &Kernels<FixedDimensions<15, 15>>::TABLE;
+    if (max_row_count == 21 && max_column_count == 21)
+        return &Kernels<FixedDimensions<21, 21>>::TABLE;
+    if (max_row_count == 25 && max_column_count == 25)
+        return &Kernels<FixedDimensions<25, 25>>::TABLE;
+    return &Kernels<RuntimeDimensions>::TABLE;
 }
 
-bool Grid::place_word_unchecked(Word const &word, Location const &loc)
+bool Grid::has_fixed_dimensions(gidx max_row_count, gidx max_column_count)
+{
+    return select_kernels(max_row_count, max_column_count)->fixed_dimensions;
+}
+
+Grid::Grid(WordStore const &words, gidx max_row_count, gidx max_column_count) :
+    m_word_store(&words),
+    m_kernels(select_kernels(max_row_count, max_column_count)),
+    m_words(&m_arena), m_letter_count(0), m_crossing_count(0),
+    // First word will be placed in the center of the internal grid.
+    // This is the passed row/column count, as row/column count is doubled internally
+    // to allow flexible placements of words in all directions
+    m_min_row_used(max_row_count), m_max_row_used(max_row_count),
+    m_min_column_used(max_column_count), m_max_column_used(max_column_count),
+    m_hash_sum(0)
 {
-    gidx cell = GIDX(loc.row, loc.column);
-    switch (loc.direction)
+    // The internal grid has double the given column and row size.
+    // That way, we can simply place the first word in the middle of the grid
+    // and still have space in all directions. Thus, we do not restrict possible
+    // solutions due to unfortunate placements of the first word.
+    // Only the window is allocated though, and every internal row/column is
+    // mapped to a window slot modulo the window size.
+    // The fixed dimension kernels expect the same layout as their constant geometry.
+    m_geometry = GridGeometry::of(max_row_count, max_column_count, m_kernels->fixed_dimensions);
+
+    m_row_slots = std::make_unique<gidx[]>(m_geometry.internal_rows + 2);
+    for (gidx row = -1; row <= m_geometry.internal_rows; row++)
     {
-    case Direction::HORIZONTAL:
-        for (auto i = 0; i < word.length; i++)
+        m_row_slots[row + 1] = (row + m_geometry.window_rows) % m_geometry.window_rows;
+    }
+    m_column_slots = std::make_unique<gidx[]>(m_geometry.internal_columns + 2);
+    for (gidx column = -1; column <= m_geometry.internal_columns; column++)
+    {
+        m_column_slots[column + 1] = (column + m_geometry.window_columns) % m_geometry.window_columns;
+    }
+
+    // padded, as segment_matches() reads past the end of the cells it is given
+    gidx gridsize = m_geometry.window_rows * m_geometry.row_stride + SEGMENT_MATCH_PADDING;
+    m_grid = std::make_unique<char[]>(gridsize);
+    std::fill(m_grid.get(), m_grid.get() + gridsize, EMPTY_CHAR);
+    gidx transposed_size = m_geometry.window_columns * m_geometry.column_stride + SEGMENT_MATCH_PADDING;
+    m_grid_transposed = std::make_unique<char[]>(transposed_size);
+    std::fill(m_grid_transposed.get(), m_grid_transposed.get() + transposed_size, EMPTY_CHAR);
+
+    m_row_bits = std::make_unique<std::uint64_t[]>(m_geometry.window_rows * m_geometry.row_line_words);
+    m_column_bits = std::make_unique<std::uint64_t[]>(m_geometry.window_columns * m_geometry.column_line_words);
+    m_cross_checks = std::make_unique<CrossCheck[]>(2 * m_geometry.window_rows * m_geometry.row_stride);
+
+    auto const hash_factors = [](gidx count, std::uint64_t factor) {
+        auto factors = std::make_unique<HashFactor[]>(count);
+        std::uint64_t const inverse = inverse_of(factor);
+        std::uint64_t power = 1, inverse_power = 1;
+        for (gidx i = 0; i < count; i++)
         {
-            if (m_grid[cell] != EMPTY_CHAR)
-                m_crossing_count++;
+            factors[i] = { power, inverse_power };
+            power *= factor;
+            inverse_power *= inverse;
+        }
+        return factors;
+    };
+    m_row_hash_factors = hash_factors(m_geometry.internal_rows, HASH_ROW_FACTOR);
+    m_column_hash_factors = hash_factors(m_geometry.internal_columns, HASH_COLUMN_FACTOR);
+}
 
-            m_grid[cell] = word[i];
-            m_char_loc_lookup[word[i]].insert(cell);
-            INC_COLUMN(cell);
+void Grid::reset()
+{
+    // works on any grid, as the runtime kernels read the geometry
+    using Runtime = Kernels<RuntimeDimensions>;
+    if (!m_words.empty())
+    {
+        // words are only ever placed within the used bounds, every other cell is still empty
+        for (auto row = m_min_row_used; row <= m_max_row_used; row++)
+        {
+            gidx const slot = Runtime::row_slot(*this, row);
+            char *cells = &m_grid[slot * m_geometry.row_stride];
+            std::fill(cells, cells + m_geometry.window_columns, EMPTY_CHAR);
+            std::fill(Runtime::row_bits(*this, slot), Runtime::row_bits(*this, slot) + m_geometry.row_line_words, 0);
         }
-        m_max_row_used = std::max(m_max_row_used, loc.row);
-        m_max_column_used = std::max(m_max_column_used, loc.column + word.length - 1);
-        break;
-    case Direction::VERTICAL:
-        for (auto i = 0; i < word.length; i++)
+        for (auto column = m_min_column_used; column <= m_max_column_used; column++)
         {
-            if (m_grid[cell] != EMPTY_CHAR)
-                m_crossing_count++;
+            gidx const slot = Runtime::column_slot(*this, column);
+            char *cells = &m_grid_transposed[slot * m_geometry.column_stride];
+            std::fill(cells, cells + m_geometry.window_rows, EMPTY_CHAR);
+            std::fill(Runtime::column_bits(*this, slot),
+                      Runtime::column_bits(*this, slot) + m_geometry.column_line_words, 0);
+        }
+    }
+
+    m_words.clear();
+    for (auto &cells : m_anchors)
+    {
+        cells.clear();
+    }
+    m_undo_log.clear();
+    m_pending_updates.clear();
+    m_letter_count = 0;
+    m_crossing_count = 0;
+    m_hash_sum = 0;
+
+    m_min_row_used = m_max_row_used = m_geometry.max_rows;
+    m_min_column_used = m_max_column_used = m_geometry.max_columns;
+}
 
-            m_grid[cell] = word[i];
-            m_char_loc_lookup[word[i]].insert(cell);
-            INC_ROW(cell);
+void Grid::assign(Grid const &other)
+{
+    using Runtime = Kernels<RuntimeDimensions>;
+    reset();
+    other.apply_pending_updates();
+    if (!other.m_words.empty())
+    {
+        // whole window rows/columns, the layout is the same in both grids
+        for (auto row = other.m_min_row_used; row <= other.m_max_row_used; row++)
+        {
+            gidx const slot = Runtime::row_slot(*this, row);
+            gidx const offset = slot * m_geometry.row_stride;
+            std::copy(&other.m_grid[offset], &other.m_grid[offset] + m_geometry.window_columns, &m_grid[offset]);
+            std::copy(Runtime::row_bits(other, slot), Runtime::row_bits(other, slot) + m_geometry.row_line_words,
+                      Runtime::row_bits(*this, slot));
+            std::copy(&other.m_cross_checks[2 * offset],
+                      &other.m_cross_checks[2 * offset] + 2 * m_geometry.window_columns,
+                      &m_cross_checks[2 * offset]);
         }
-        m_max_row_used = std::max(m_max_row_used, loc.row + word.length - 1);
-        m_max_column_used = std::max(m_max_column_used, loc.column);
-        break;
+        for (auto column = other.m_min_column_used; column <= other.m_max_column_used; column++)
+        {
+            gidx const slot = Runtime::column_slot(*this, column);
+            gidx const offset = slot * m_geometry.column_stride;
+            std::copy(&other.m_grid_transposed[offset], &other.m_grid_transposed[offset] + m_geometry.window_rows,
+                      &m_grid_transposed[offset]);
+            std::copy(Runtime::column_bits(other, slot),
+                      Runtime::column_bits(other, slot) + m_geometry.column_line_words,
+                      Runtime::column_bits(*this, slot));
+        }
+    }
+
+    // the containers keep allocating from this grid's arena
+    m_words = other.m_words;
+    m_anchors = other.m_anchors;
+    m_undo_log = other.m_undo_log;
+    m_letter_count = other.m_letter_count;
+    m_crossing_count = other.m_crossing_count;
+    m_hash_sum = other.m_hash_sum;
+
+    m_min_row_used = other.m_min_row_used;
+    m_max_row_used = other.m_max_row_used;
+    m_min_column_used = other.m_min_column_used;
+    m_max_column_used = other.m_max_column_used;
+}
+
+bool Grid::is_in_bounds(wid word, Location const &loc) const
+{
+    return m_kernels->is_in_bounds(*this, (*m_word_store)[word], loc);
+}
+
+bool Grid::is_valid_placement(wid word, Location const &loc) const
+{
+    return m_kernels->is_valid_placement(*this, (*m_word_store)[word], loc);
+}
+
+bool Grid::place_word_unchecked(wid id, Location const &loc)
+{
+    Word const word = (*m_word_store)[id];
+    m_undo_log.push_back({ loc, m_min_row_used, m_max_row_used, m_min_column_used, m_max_column_used });
+
+    m_kernels->place_word_unchecked(*this, word, loc);
+
+    if (m_undo_log.size() == 1)
+    {
+        // the bounds of the empty grid are just the center, see constructor
+        m_min_row_used = m_max_row_used = loc.row;
+        m_min_column_used = m_max_column_used = loc.column;
     }
+    // Hack to avoid branching. Assumes that vertical = 0, horizontal = 1
+    m_max_row_used = std::max(m_max_row_used, loc.row + (word.length - 1) * (1 - loc.direction));
+    m_max_column_used = std::max(m_max_column_used, loc.column + (word.length - 1) * loc.direction);
     m_min_column_used = std::min(m_min_column_used, loc.column);
     m_min_row_used = std::min(m_min_row_used, loc.row);
 
-    std::pair<Location, Word> placement(loc, word);
-    m_words.insert(std::move(placement));
+    m_words.emplace(loc, id);
+    m_pending_updates.push_back({ loc, id, true });
+    m_hash_sum += hash_term(id, loc);
 
     return true;
 }
 
-bool Grid::place_word(Word const &word, Location const &loc)
+bool Grid::place_word(wid word, Location const &loc)
 {
     if (!is_valid_placement(word, loc))
         return false;
@@ -203,7 +977,7 @@ bool Grid::place_word(Word const &word, Location const &loc)
     return place_word_unchecked(word, loc);
 }
 
-bool Grid::place_first_word(Word const &word, Direction direction)
+bool Grid::place_first_word(wid word, Direction direction)
 {
     if (!m_words.empty())
     {
@@ -211,90 +985,255 @@ bool Grid::place_first_word(Word const &word, Direction direction)
     }
 
     // calculate the start position of the word, so that its in the middle of the grid
-    Location loc = { m_internal_row_count / 2,  m_internal_column_count / 2, direction };
+    Location loc = { m_geometry.internal_rows / 2,  m_geometry.internal_columns / 2, direction };
     switch (direction)
     {
     case Direction::HORIZONTAL:
-        loc.column -= word.length / 2;
+        loc.column -= m_word_store->length(word) / 2;
         break;
     case Direction::VERTICAL:
-        loc.row -= word.length / 2;
+        loc.row -= m_word_store->length(word) / 2;
         break;
     }
 
     return place_word(word, loc);
 }
 
-void Grid::get_valid_placements(Word const &word, std::vector<grid::Location> &buffer) const
+std::uint64_t Grid::hash_term(wid word, Location const &loc) const
+{
+    // splitmix64 of word and direction as the word's Zobrist key
+    std::uint64_t key = 2 * std::uint64_t(word) + loc.direction + 0x9E3779B97F4A7C15ULL;
+    key = (key ^ (key >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    key = (key ^ (key >> 27)) * 0x94D049BB133111EBULL;
+    key ^= key >> 31;
+    return key * m_row_hash_factors[loc.row].power * m_column_hash_factors[loc.column].power;
+}
+
+void Grid::add_anchor(char letter, gidx cell)
+{
+    m_anchors[static_cast<unsigned char>(letter)].push_back(cell);
+}
+
+void Grid::remove_anchor(char letter, gidx cell)
+{
+    // Search from the back, as cells are mostly removed in reverse order of
+    // their insertion when backtracking. The order of the cells is irrelevant.
+    auto &cells = m_anchors[static_cast<unsigned char>(letter)];
+    auto it = std::find(cells.rbegin(), cells.rend(), cell);
+    if (it != cells.rend())
+    {
+        *it = cells.back();
+        cells.pop_back();
+    }
+}
+
+void Grid::recompute_bounds()
 {
-    for (auto cidx = 0; cidx < word.length; cidx++)
+    // bounds of the empty grid, see constructor
+    gidx min_row = m_geometry.max_rows, max_row = m_geometry.max_rows;
+    gidx min_col = m_geometry.max_columns, max_col = m_geometry.max_columns;
+
+    for (std::size_t i = 0; i < m_undo_log.size(); i++)
     {
-        auto const &letter = word[cidx];
-        if (m_char_loc_lookup.count(letter) > 0)
+        UndoRecord &record = m_undo_log[i];
+        record.min_row_used = min_row;
+        record.max_row_used = max_row;
+        record.min_column_used = min_col;
+        record.max_column_used = max_col;
+
+        Location const &loc = record.loc;
+        gidx const length = m_word_store->length(m_words.at(loc));
+        // Hack to avoid branching. Assumes that vertical = 0, horizontal = 1
+        gidx const end_row = loc.row + (length - 1) * (1 - loc.direction);
+        gidx const end_col = loc.column + (length - 1) * loc.direction;
+        if (i == 0)
         {
-            for (auto const &cell : m_char_loc_lookup.at(letter))
-            {
-                gidx const row = cell / m_internal_column_count;
-                gidx const col = cell % m_internal_column_count;
-                Location loc = {row - cidx, col, Direction::VERTICAL};
-                if (is_valid_placement(word, loc))
-                {
-                    buffer.push_back(loc);
-                }
-                loc = {row, col - cidx, Direction::HORIZONTAL};
-                if (is_valid_placement(word, loc))
-                {
-                    buffer.push_back(loc);
-                }
-            }
+            min_row = loc.row;
+            max_row = end_row;
+            min_col = loc.column;
+            max_col = end_col;
+        }
+        else
+        {
+            min_row = std::min(min_row, loc.row);
+            max_row = std::max(max_row, end_row);
+            min_col = std::min(min_col, loc.column);
+            max_col = std::max(max_col, end_col);
         }
     }
+
+    m_min_row_used = min_row;
+    m_max_row_used = max_row;
+    m_min_column_used = min_col;
+    m_max_column_used = max_col;
 }
 
-std::int_fast32_t Grid::get_height() const
+bool Grid::remove_last_word()
 {
-    return m_max_row_used - m_min_row_used + 1;
+    if (m_undo_log.empty())
+        return false;
+
+    UndoRecord const &record = m_undo_log.back();
+    wid const id = m_words.at(record.loc);
+    m_kernels->clear_word_cells(*this, (*m_word_store)[id], record.loc);
+    m_hash_sum -= hash_term(id, record.loc);
+
+    // if the placement is still pending, the cross-checks are as before it
+    if (!m_pending_updates.empty() && m_pending_updates.back().placed
+        && m_pending_updates.back().loc == record.loc)
+    {
+        m_pending_updates.pop_back();
+    }
+    else
+    {
+        m_pending_updates.push_back({ record.loc, id, false });
+    }
+
+    m_min_row_used = record.min_row_used;
+    m_max_row_used = record.max_row_used;
+    m_min_column_used = record.min_column_used;
+    m_max_column_used = record.max_column_used;
+
+    m_words.erase(record.loc);
+    m_undo_log.pop_back();
+    return true;
 }
 
-std::int_fast32_t Grid::get_width() const
+bool Grid::remove_word(Location const &loc)
 {
-    return m_max_column_used - m_min_column_used + 1;
+    if (m_words.count(loc) == 0)
+        return false;
+
+    if (m_undo_log.back().loc == loc)
+        return remove_last_word();
+
+    wid const id = m_words.at(loc);
+    m_kernels->clear_word_cells(*this, (*m_word_store)[id], loc);
+    m_hash_sum -= hash_term(id, loc);
+    m_pending_updates.push_back({ loc, id, false });
+    m_words.erase(loc);
+    m_undo_log.erase(std::find_if(m_undo_log.begin(), m_undo_log.end(),
+                                  [&loc](UndoRecord const &record) { return record.loc == loc; }));
+    recompute_bounds();
+    return true;
 }
 
-std::int_fast32_t Grid::get_placed_letter_count() const
+void Grid::apply_pending_updates() const
 {
-    std::int_fast32_t count = 0;
-    for (auto const &[key, char_locs] : m_char_loc_lookup)
+    for (auto const &update : m_pending_updates)
     {
-        count += char_locs.size();
+        m_kernels->update_cross_checks(*this, (*m_word_store)[update.word], update.loc);
     }
-    return count;
+    m_pending_updates.clear();
 }
 
-std::int_fast32_t Grid::get_placed_word_count() const
+void Grid::get_valid_placements(wid id, std::vector<grid::Location> &buffer) const
 {
-    return m_words.size();
+    apply_pending_updates();
+    m_kernels->get_valid_placements(*this, (*m_word_store)[id], buffer);
 }
 
-std::int_fast32_t Grid::get_word_crossing_count() const
+void Grid::get_crossing_slots(std::vector<CrossingSlot> &buffer) const
 {
-    return m_crossing_count;
+    using Runtime = Kernels<RuntimeDimensions>;
+    apply_pending_updates();
+    for (std::size_t letter = 0; letter < m_anchors.size(); letter++)
+    {
+        for (gidx const anchor : m_anchors[letter])
+        {
+            auto const [row, column] = Runtime::anchor_position(*this, anchor);
+            for (Direction const dir : { Direction::VERTICAL, Direction::HORIZONTAL })
+            {
+                CrossCheck const &check = m_cross_checks[2 * anchor + dir];
+                buffer.push_back({ row, column, dir, static_cast<char>(letter), check.reach_before,
+                                   check.reach_after, check.stop_before, check.stop_after });
+            }
+        }
+    }
+}
+
+void Grid::get_open_anchor_counts(std::array<std::int_fast32_t, Alphabet::MAX_SIZE> &counts) const
+{
+    apply_pending_updates();
+    for (std::size_t letter = 0; letter < m_anchors.size(); letter++)
+    {
+        counts[letter] = 0;
+        for (gidx const anchor : m_anchors[letter])
+        {
+            CrossCheck const &vertical = m_cross_checks[2 * anchor + Direction::VERTICAL];
+            CrossCheck const &horizontal = m_cross_checks[2 * anchor + Direction::HORIZONTAL];
+            counts[letter] += vertical.reach_before + vertical.reach_after + horizontal.reach_before
+                              + horizontal.reach_after > 0;
+        }
+    }
+}
+
+void Grid::get_layout_metrics(LayoutMetrics &metrics) const
+{
+    m_kernels->get_layout_metrics(*this, metrics);
 }
 
 char Grid::get_cell_content(gidx row, gidx column) const
 {
+    using Runtime = Kernels<RuntimeDimensions>;
     if (row < 0 || row >= get_height() || column < 0 || column >= get_width())
         return EMPTY_CHAR;
 
-    return m_grid[GIDX(m_min_row_used + row, m_min_column_used + column)];
+    return m_grid[Runtime::cell(*this, Runtime::row_slot(*this, m_min_row_used + row),
+                                Runtime::column_slot(*this, m_min_column_used + column))];
 }
 
-Word const * Grid::get_word_starting_at(gidx row, gidx column, Direction dir) const
+std::string_view Grid::get_cell_glyph(gidx row, gidx column) const
+{
+    return m_word_store->alphabet().glyph(get_cell_content(row, column));
+}
+
+wid const * Grid::get_word_starting_at(gidx row, gidx column, Direction dir) const
 {
     row += m_min_row_used;
     column += m_min_column_used;
-    Location const loc = {row, column, dir};
+    return get_word_at({row, column, dir});
+}
 
+std::uint64_t Grid::get_hash() const
+{
+    // Moving all words by (dr, dc) multiplies every term by the factors'
+    // powers dr and dc. Dividing by the powers of the used bounds' minimum
+    // thus makes the hash independent of where the words lie.
+    return m_hash_sum * m_row_hash_factors[m_min_row_used].inverse_power
+           * m_column_hash_factors[m_min_column_used].inverse_power;
+}
+
+std::int_fast32_t Grid::get_word_crossing_count(Location const &loc) const
+{
+    using Runtime = Kernels<RuntimeDimensions>;
+    if (m_words.count(loc) == 0)
+        return 0;
+
+    std::int_fast32_t count = 0;
+    // Hack to avoid branching. Assumes that vertical = 0, horizontal = 1
+    for (auto i = 0; i < m_word_store->length(m_words.at(loc)); i++)
+    {
+        count += Runtime::is_crossing_cell(*this, loc.row + i * (1 - loc.direction), loc.column + i * loc.direction,
+                                           loc.direction);
+    }
+    return count;
+}
+
+std::int_fast32_t Grid::get_placement_crossing_count(wid word, Location const &loc) const
+{
+    using Runtime = Kernels<RuntimeDimensions>;
+    std::int_fast32_t count = 0;
+    for (auto i = 0; i < m_word_store->length(word); i++)
+    {
+        count += m_grid[Runtime::cell(*this, Runtime::row_slot(*this, loc.row + i * (1 - loc.direction)),
+                                      Runtime::column_slot(*this, loc.column + i * loc.direction))] != EMPTY_CHAR;
+    }
+    return count;
+}
+
+wid const * Grid::get_word_at(Location const &loc) const
+{
     if (m_words.count(loc) > 0)
     {
         return &m_words.at(loc);
@@ -302,6 +1241,19 @@ Word const * Grid::get_word_starting_at(gidx row, gidx column, Direction dir) co
     return nullptr;
 }
 
+WordStore const & Grid::get_word_store() const
+{
+    return *m_word_store;
+}
+
+void Grid::get_placed_locations(std::vector<grid::Location> &buffer) const
+{
+    for (auto const &record : m_undo_log)
+    {
+        buffer.push_back(record.loc);
+    }
+}
+
 void Grid::print_on_console(bool full_internal_grid) const
 {
     std::ostringstream os;
@@ -312,17 +1264,19 @@ void Grid::print_on_console(bool full_internal_grid) const
     os << "Number of charactes placed: " << get_placed_letter_count() << std::endl;
     os << "Number of word crossings: " << get_word_crossing_count() << std::endl;
 
-    size_t start_row = full_internal_grid ? 0 : m_min_row_used;
-    size_t start_col = full_internal_grid ? 0 : m_min_column_used;
-    size_t end_row = full_internal_grid ? m_internal_row_count - 1 : m_max_row_used;
-    size_t end_col = full_internal_grid ? m_internal_column_count - 1 : m_max_column_used;
+    gidx start_row = full_internal_grid ? 0 : m_min_row_used;
+    gidx start_col = full_internal_grid ? 0 : m_min_column_used;
+    gidx end_row = full_internal_grid ? m_geometry.internal_rows - 1 : m_max_row_used;
+    gidx end_col = full_internal_grid ? m_geometry.internal_columns - 1 : m_max_column_used;
 
     for (auto row = start_row; row <= end_row; row++)
     {
         os << " ";
         for (auto column = start_col; column <= end_col; column++)
         {
-            os << m_grid[GIDX(row, column)];
+            // only the used bounds are stored in the window, get_cell_content()
+            // is relative to them
+            os << get_cell_glyph(row - m_min_row_used, column - m_min_column_used);
         }
         os << std::endl;
     }
@@ -1,11 +1,13 @@
 #pragma once
 
+#include <array>
 #include <cstdint>
 #include <utility>
 #include <vector>
 #include <map>
-#include <set>
 #include <memory>
+#include <memory_resource>
+#include <string_view>
 
 #include "word.h"
 
@@ -26,51 +28,299 @@ typedef struct Location
     grid::Direction direction;
 
     bool operator<(Location const &other) const;
+    bool operator==(Location const &other) const;
 } Location;
 
+/**
+    A placed letter that a new word can still cross, with the free runs
+    around it in the direction of such a word. A word through the cell that
+    stays within the free runs is valid, as long as its ends do not touch a
+    stop letter.
+ */
+typedef struct CrossingSlot
+{
+    // internal row/column of the cell
+    gidx row;
+    gidx column;
+    // direction of a word crossing the cell
+    grid::Direction direction;
+    char letter;
+    // number of free cells before/after the cell, capped at the length of the longest word
+    std::uint16_t reach_before;
+    std::uint16_t reach_after;
+    // letter ending the free run before/after the cell, or Grid::EMPTY_CHAR
+    char stop_before;
+    char stop_after;
+} CrossingSlot;
+
+/**
+    Layout figures of the used bounds of a grid, see Grid::get_layout_metrics().
+ */
+typedef struct LayoutMetrics
+{
+    // cells holding a letter, a crossing counts once
+    std::int_fast32_t letter_count;
+    // cells of the used bounds
+    std::int_fast32_t area;
+    // groups of letters that no chain of words connects to each other
+    std::int_fast32_t island_count;
+    // longest run of consecutive letters of a word that no other word crosses
+    std::int_fast32_t longest_uncrossed_run;
+    // Sum of the deviations of the letters per row/column from their mean,
+    // rounded down. 0 if all rows/columns hold the same number of letters.
+    std::int_fast32_t row_imbalance;
+    std::int_fast32_t column_imbalance;
+} LayoutMetrics;
+
+/**
+    Layout of a grid's storage, derived from its maximum dimensions.
+ */
+typedef struct GridGeometry
+{
+    // maximum number of rows/columns that can be used by valid crossword
+    gidx max_rows;
+    gidx max_columns;
+    // Size of the internal grid, which locations refer to. It is twice the
+    // maximum size, so that the first word can be placed in the middle and
+    // the crossword can still grow in all directions.
+    gidx internal_rows;
+    gidx internal_columns;
+    // size of the stored window of the internal grid, see Grid::m_grid
+    gidx window_rows;
+    gidx window_columns;
+    // distance between window rows in Grid::m_grid and between window
+    // columns in Grid::m_grid_transposed
+    gidx row_stride;
+    gidx column_stride;
+    // 64 bit words per bitboard line, see Grid::m_row_bits
+    gidx row_line_words;
+    gidx column_line_words;
+
+    /**
+        Geometry for the given maximum dimensions. Power-of-two strides
+        turn cell index arithmetic into shifts and masks, at the cost of
+        some unused cells per window row/column.
+     */
+    static constexpr GridGeometry of(gidx max_rows, gidx max_columns, bool power_of_two_strides)
+    {
+        gidx const window_rows = max_rows + 2;
+        gidx const window_columns = max_columns + 2;
+        gidx row_stride = window_columns, column_stride = window_rows;
+        if (power_of_two_strides)
+        {
+            for (row_stride = 1; row_stride < window_columns; row_stride *= 2) {}
+            for (column_stride = 1; column_stride < window_rows; column_stride *= 2) {}
+        }
+        // slots -1 to twice the window size plus one extra word, see Grid::m_row_bits
+        return { max_rows, max_columns, 2 * max_rows, 2 * max_columns, window_rows, window_columns,
+                 row_stride, column_stride, (2 * window_columns + 2 + 63) / 64 + 1,
+                 (2 * window_rows + 2 + 63) / 64 + 1 };
+    }
+} GridGeometry;
+
 class Grid
 {
 private:
-    // size of the internal grid
-    gidx m_internal_row_count;
-    gidx m_internal_column_count;
+    // Cross-check data of an occupied cell for crossing it with a word in one
+    // direction, in the style of Scrabble move generators. A cell is free if it
+    // is empty and has no neighbours across the direction, so a word can run
+    // through it. The letter a crossing word needs at the cell is the cell's own.
+    typedef struct CrossCheck
+    {
+        // number of free cells before/after the cell, capped at the length of
+        // the longest word
+        std::uint16_t reach_before;
+        std::uint16_t reach_after;
+        // Letter of the occupied cell ending the free run before/after the
+        // cell, or EMPTY_CHAR if the run ends otherwise. A word longer than the
+        // run has to cross this letter.
+        char stop_before;
+        char stop_after;
+    } CrossCheck;
+
+    // a placement or removal whose cross-checks are not updated yet
+    typedef struct PendingUpdate
+    {
+        Location loc;
+        wid word;
+        bool placed;
+    } PendingUpdate;
+
+    // state needed to revert a placement with remove_last_word()
+    typedef struct UndoRecord
+    {
+        Location loc;
+        gidx min_row_used;
+        gidx max_row_used;
+        gidx min_column_used;
+        gidx max_column_used;
+    } UndoRecord;
+
+    // The functions depending on the grid's dimensions, compiled once for
+    // runtime dimensions and once for each of a few common fixed dimensions,
+    // where all strides and bounds are constants. See grid.cpp.
+    template<typename Dimensions> struct Kernels;
+    typedef struct KernelTable
+    {
+        bool fixed_dimensions;
+        bool (*is_in_bounds)(Grid const &grid, Word const &word, grid::Location const &loc);
+        bool (*is_valid_placement)(Grid const &grid, Word const &word, grid::Location const &loc);
+        void (*place_word_unchecked)(Grid &grid, Word const &word, grid::Location const &loc);
+        void (*clear_word_cells)(Grid &grid, Word const &word, grid::Location const &loc);
+        void (*update_cross_checks)(Grid const &grid, Word const &word, grid::Location const &loc);
+        void (*get_valid_placements)(Grid const &grid, Word const &word, std::vector<grid::Location> &buffer);
+        void (*get_layout_metrics)(Grid const &grid, LayoutMetrics &metrics);
+    } KernelTable;
+
+    static KernelTable const * select_kernels(gidx max_row_count, gidx max_column_count);
+
+    // powers of a hash factor and of its multiplicative inverse, see get_hash()
+    typedef struct HashFactor
+    {
+        std::uint64_t power;
+        std::uint64_t inverse_power;
+    } HashFactor;
+
+    // all words that can be placed on the grid. Words are referred to by their id
+    WordStore const *m_word_store;
+
+    GridGeometry m_geometry;
+    // chosen once on construction, from the maximum dimensions
+    KernelTable const *m_kernels;
+
+    // Only a window of the internal grid is stored: the used bounds, which
+    // are at most max rows x max columns, and the empty border around them.
+    // Every internal row/column maps to the window slot of its index modulo
+    // the window size, so the window follows the used bounds wherever they
+    // move, without ever shifting any cells.
+    // slot of every internal row/column, including -1 and one past the last
+    std::unique_ptr<gidx[]> m_row_slots;
+    std::unique_ptr<gidx[]> m_column_slots;
     std::unique_ptr<char[]> m_grid;
+    // Transposed copy of m_grid (column-major), so that the cells of vertical
+    // words are contiguous as well
+    std::unique_ptr<char[]> m_grid_transposed;
+
+    // Occupancy bitboards, one bit per cell. m_row_bits holds one line of bits
+    // per window row, m_column_bits one line per window column. A line holds
+    // the slots -1 to twice the window size, i.e. the window repeated, so any
+    // run of cells along the line, including its neighbours, is contiguous.
+    std::unique_ptr<std::uint64_t[]> m_row_bits;
+    std::unique_ptr<std::uint64_t[]> m_column_bits;
+
+    // Two cross-checks per cell, one for each direction. Only up-to-date for
+    // occupied cells and only once the pending updates have been applied.
+    // Updating lazily makes a placement that is undone before the next
+    // get_valid_placements() free, which is what the search engines mostly do.
+    std::unique_ptr<CrossCheck[]> m_cross_checks;
+    mutable std::vector<PendingUpdate> m_pending_updates;
+
+    // Scratch space of get_layout_metrics(), kept so that it stops allocating:
+    // the cells of the previous row in an uncrossed run along the columns and
+    // the row each of those runs started in, the runs of letters along the rows as first
+    // and last column, and the union-find parent of every run.
+    mutable std::vector<std::uint64_t> m_metric_lines;
+    mutable std::vector<std::int_fast32_t> m_metric_columns;
+    mutable std::vector<std::pair<gidx, gidx> > m_metric_runs;
+    mutable std::vector<std::size_t> m_metric_parents;
+
+    // Node based containers below allocate from this arena. Nodes freed by
+    // reset() or remove_last_word() go back to the arena and are reused by
+    // later placements, so a reused grid does not hit malloc anymore.
+    // Must be declared before the containers using it.
+    std::pmr::unsynchronized_pool_resource m_arena;
 
     // words placed on the grid
-    std::map<grid::Location, Word> m_words;
+    std::pmr::map<grid::Location, wid> m_words;
 
-    std::map<char, std::set<gidx> > m_char_loc_lookup;
+    // Anchor index: for every letter, the window cells holding it that can
+    // still be crossed by a new word. Cells that already are a crossing are removed.
+    // The vectors keep their capacity on reset(), so they stop allocating
+    // once a grid has been used for a few restarts.
+    std::array<std::vector<gidx>, Alphabet::MAX_SIZE> m_anchors;
+    std::int_fast32_t m_letter_count;
     std::int_fast32_t m_crossing_count;
 
-    // maximum number of rows/columns that can be used by valid crossword.
-    // Note: m_internal_[row/column]_count may be larger to allow for flexibility
-    // in adding new words
-    gidx m_max_row_count;
-    gidx m_max_column_count;
-
     // bounds used by the words places on the current grid
     gidx m_min_row_used;
     gidx m_max_row_used;
     gidx m_min_column_used;
     gidx m_max_column_used;
 
+    // placements in the order they were made
+    std::vector<UndoRecord> m_undo_log;
+
+    // Sum of the hash terms of all placed words, see hash_term()
+    std::uint64_t m_hash_sum;
+    // factors for every internal row/column, indexed by row/column
+    std::unique_ptr<HashFactor[]> m_row_hash_factors;
+    std::unique_ptr<HashFactor[]> m_column_hash_factors;
+
+    /**
+        Hash term of a word placed at 'loc': a random key of the word and its
+        direction, times the row's and the column's factor.
+     */
+    std::uint64_t hash_term(wid word, grid::Location const &loc) const;
+
+    void add_anchor(char letter, gidx cell);
+    void remove_anchor(char letter, gidx cell);
+
+    /**
+        Recomputes the cross-checks affected by the placements and removals
+        since the last call.
+     */
+    void apply_pending_updates() const;
+
+    /**
+        Recomputes the used bounds, as well as the bounds stored in the undo log,
+        from the placed words.
+     */
+    void recompute_bounds();
+
 public:
-    static char const EMPTY_CHAR;
+    // cell content of empty cells
+    static constexpr char EMPTY_CHAR = Alphabet::EMPTY;
+
+    /**
+        Constructs an empty grid for the words of 'words', which must outlive the grid.
+     */
+    Grid(WordStore const &words, gidx max_row_count, gidx max_column_count);
+
+    /**
+        Checks if the grid functions are compiled specifically for grids of
+        these maximum dimensions. Other sizes use the runtime-sized versions.
+     */
+    static bool has_fixed_dimensions(gidx max_row_count, gidx max_column_count);
+
+    Grid(Grid const &) = delete;
+    Grid & operator=(Grid const &) = delete;
 
-    Grid(gidx max_row_count, gidx max_column_count);
+    /**
+        Removes all words from the grid, so that it can be reused for a new
+        crossword. Only the cells within the used bounds are cleared and the
+        container nodes are kept in the grid's arena.
+     */
+    void reset();
+
+    /**
+        Makes this grid a copy of 'other', which must have the same maximum
+        dimensions. Only the used bounds of 'other' are copied, not the whole
+        internal grid, so this is cheap for the partially filled grids of a search.
+     */
+    void assign(Grid const &other);
 
     /**
         Checks if the word 'word' can be placed at location 'loc' without running
         out-of-bounds and violating the size constraints of the grid.
      */
-    bool is_in_bounds(Word const &word, grid::Location const &loc) const;
+    bool is_in_bounds(wid word, grid::Location const &loc) const;
 
     /**
         Checks if this word placement is valid. I.e, it is not out-of-bounds
         and does not create a conflict with any adjecent or crossing words
         already placed on the grid.
      */
-    bool is_valid_placement(Word const &word, grid::Location const &loc) const;
+    bool is_valid_placement(wid word, grid::Location const &loc) const;
 
     /**
         Place a word on grid.  Note that no validity our out-of-bounds checks
@@ -81,7 +331,7 @@ public:
 
         @return true if the word was placed successfully, otherwise false.
      */
-    bool place_word_unchecked(Word const &word, grid::Location const &loc);
+    bool place_word_unchecked(wid word, grid::Location const &loc);
 
     /**
         Places a word on the grid. Before placement, the validity of the placement
@@ -89,26 +339,134 @@ public:
 
         @return true if the word was placed successfully, otherwise false.
      */
-    bool place_word(Word const &word, grid::Location const &loc);
+    bool place_word(wid word, grid::Location const &loc);
 
     /**
         Place this first word in an empty grid.
         @return true if word was successfully placed. False if word could not be
         placed, e.g. because the grid is not empty.
      */
-    bool place_first_word(Word const &word, grid::Direction direction);
+    bool place_first_word(wid word, grid::Direction direction);
+
+    /**
+        Removes the word placed last and restores the grid to the state before
+        its placement. Cells shared with crossing words are kept. Runs in
+        O(word length), so search engines can use it to backtrack.
+
+        @return true if a word was removed, false if the grid is empty.
+     */
+    bool remove_last_word();
+
+    /**
+        Removes the word starting at location 'loc'. Cells shared with crossing
+        words are kept. Unlike remove_last_word(), this works for any placed
+        word, but the used bounds have to be recomputed from all placed words
+        unless 'loc' is the last placement.
+
+        Note that removing a word crossing several others may split the grid.
+
+        @return true if a word was removed, false if no word starts at 'loc'.
+     */
+    bool remove_word(grid::Location const &loc);
+
+    /**
+        Appends all valid placements of the word to buffer. Candidates are
+        taken from the anchor index and mostly decided by the anchors'
+        cross-checks, only placements crossing several words are validated in
+        full. Applies pending cross-check updates, so unlike the other const
+        functions, this must not be called concurrently on the same grid.
+     */
+    void get_valid_placements(wid word, std::vector<grid::Location> & buffer) const;
+
+    /**
+        Appends a slot for every placed letter that is not a crossing yet
+        and each direction a word could cross it in. Engines that pick words
+        from a large pool look up words fitting these slots instead of trying
+        every word. Applies pending cross-check updates, like get_valid_placements().
+     */
+    void get_crossing_slots(std::vector<CrossingSlot> &buffer) const;
+
+    /**
+        Counts, for every letter, the placed letters that are not a crossing
+        yet and have a free cell next to them in at least one direction,
+        i.e. the letters a new word can still cross. Cheaper than
+        get_crossing_slots() and likewise applies pending cross-check updates.
+     */
+    void get_open_anchor_counts(std::array<std::int_fast32_t, Alphabet::MAX_SIZE> &counts) const;
+
+    /**
+        Measures the layout of the used bounds in a single sweep over the
+        occupancy bitboards, 64 cells at a time. The islands are found by a
+        union-find over the runs of letters along the rows. Uses scratch space
+        of the grid, so this must not be called concurrently on the same grid.
+     */
+    void get_layout_metrics(LayoutMetrics &metrics) const;
+
+
+    // Various getter functions. The ones scorers use are defined here, so
+    // that they are inlined into the scoring code.
+    std::int_fast32_t get_height() const
+    {
+        return m_max_row_used - m_min_row_used + 1;
+    }
+
+    std::int_fast32_t get_width() const
+    {
+        return m_max_column_used - m_min_column_used + 1;
+    }
+
+    std::int_fast32_t get_max_height() const
+    {
+        return m_geometry.max_rows;
+    }
 
-    void get_valid_placements(Word const &word, std::vector<grid::Location> & buffer) const;
+    std::int_fast32_t get_max_width() const
+    {
+        return m_geometry.max_columns;
+    }
 
+    std::int_fast32_t get_placed_letter_count() const
+    {
+        return m_letter_count;
+    }
 
-    // Various getter functions
-    std::int_fast32_t get_height() const;
-    std::int_fast32_t get_width() const;
-    std::int_fast32_t get_placed_letter_count() const;
-    std::int_fast32_t get_placed_word_count() const;
-    std::int_fast32_t get_word_crossing_count() const;
+    std::int_fast32_t get_placed_word_count() const
+    {
+        return m_words.size();
+    }
+
+    std::int_fast32_t get_word_crossing_count() const
+    {
+        return m_crossing_count;
+    }
+
+    // alphabet code of the letter in the cell, relative to the used bounds
     char get_cell_content(gidx row, gidx column) const;
-    Word const * get_word_starting_at(gidx row, gidx column, grid::Direction dir) const;
+    // UTF-8 text of the letter in the cell
+    std::string_view get_cell_glyph(gidx row, gidx column) const;
+    wid const * get_word_starting_at(gidx row, gidx column, grid::Direction dir) const;
+
+    /**
+        Zobrist style hash of the placed words and their locations relative to
+        the used bounds. Grids with the same words at the same places have the
+        same hash, wherever they lie within the internal grid. Updated with
+        every placement and removal, so this is O(1).
+     */
+    std::uint64_t get_hash() const;
+
+    // Getters using internal locations, as used by placements
+    std::int_fast32_t get_word_crossing_count(grid::Location const &loc) const;
+    /**
+        Number of placed letters a valid placement of the word at 'loc' would
+        cross, without placing it.
+     */
+    std::int_fast32_t get_placement_crossing_count(wid word, grid::Location const &loc) const;
+    wid const * get_word_at(grid::Location const &loc) const;
+    WordStore const & get_word_store() const;
+    /**
+        Appends the locations of all placed words to buffer, in placement order.
+     */
+    void get_placed_locations(std::vector<grid::Location> &buffer) const;
 
 
     /**
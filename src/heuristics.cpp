@@ -0,0 +1,145 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <utility>
+
+#include "heuristics.h"
+
+using namespace search;
+
+Heuristics::Heuristics(HeuristicSettings const &settings, WordStore const &words, CrossingIndex const &crossings) :
+    m_settings(settings), m_first_word_candidates(words.size(), 0), m_difficulty(words.size(), 0.0)
+{
+    std::vector<std::pair<std::size_t, wid> > degrees;
+    for (wid id = 0; id < words.size(); id++)
+    {
+        if (!crossings.can_cross(id))
+            continue;
+        auto const crossing_words = crossings.crossing_words(id);
+        degrees.emplace_back(crossing_words.end() - crossing_words.begin(), id);
+        m_first_word_candidates[id] = 1;
+    }
+    if (m_settings.first_word == FirstWordRule::MOST_CONNECTED && degrees.size() > FIRST_WORD_CANDIDATES)
+    {
+        // the candidates are the words crossing the most other words, ties go to the lower id
+        std::nth_element(degrees.begin(), degrees.begin() + FIRST_WORD_CANDIDATES, degrees.end(),
+                         [](auto const &lhs, auto const &rhs) {
+                             return lhs.first > rhs.first || (lhs.first == rhs.first && lhs.second < rhs.second);
+                         });
+        for (auto it = degrees.begin() + FIRST_WORD_CANDIDATES; it != degrees.end(); ++it)
+        {
+            m_first_word_candidates[it->second] = 0;
+        }
+    }
+
+    double total = 0;
+    for (std::size_t code = 1; code < words.alphabet().size(); code++)
+    {
+        total += words.letter_count(code);
+    }
+    for (std::size_t code = 1; code < words.alphabet().size() && total > 0; code++)
+    {
+        m_letter_frequency[code] = words.letter_count(code) / total;
+    }
+    for (wid id = 0; id < words.size(); id++)
+    {
+        for (char const letter : words.letters(id))
+        {
+            m_difficulty[id] -= std::log2(m_letter_frequency[static_cast<unsigned char>(letter)]);
+        }
+    }
+}
+
+HeuristicSettings const & Heuristics::get_settings() const
+{
+    return m_settings;
+}
+
+bool Heuristics::is_first_word_candidate(wid word) const
+{
+    return m_first_word_candidates[word] != 0;
+}
+
+void Heuristics::order_words(std::vector<wid> &words, std::default_random_engine &rng) const
+{
+    std::shuffle(words.begin(), words.end(), rng);
+    if (m_settings.word_order != WordOrderRule::HARDEST_FIRST)
+        return;
+
+    // Scaling the difficulties by a random factor keeps the order roughly
+    // hardest first, but lets different restarts try the words in different orders.
+    std::uniform_real_distribution<double> jitter(1.0, 2.0);
+    std::vector<std::pair<double, wid> > keyed;
+    keyed.reserve(words.size());
+    for (wid const word : words)
+    {
+        keyed.emplace_back(m_difficulty[word] * jitter(rng), word);
+    }
+    std::stable_sort(keyed.begin(), keyed.end(),
+                     [](auto const &lhs, auto const &rhs) { return lhs.first > rhs.first; });
+    for (std::size_t i = 0; i < keyed.size(); i++)
+    {
+        words[i] = keyed[i].second;
+    }
+}
+
+std::size_t Heuristics::choose_placement(grid::Grid &grid, wid word, std::vector<grid::Location> const &placements,
+                                         std::default_random_engine &rng) const
+{
+    if (m_settings.placement != PlacementRule::MOST_CROSSINGS || placements.size() == 1)
+    {
+        std::uniform_int_distribution<int> loc_dist(0, placements.size() - 1);
+        return loc_dist(rng);
+    }
+
+    // Only the placements crossing the most words are tried on the grid, as
+    // counting the open letters is by far the more expensive part.
+    std::vector<std::size_t> most_crossing;
+    std::int_fast32_t most_crossings = 0;
+    for (std::size_t i = 0; i < placements.size(); i++)
+    {
+        std::int_fast32_t const crossings = grid.get_placement_crossing_count(word, placements[i]);
+        if (crossings > most_crossings)
+        {
+            most_crossing.clear();
+            most_crossings = crossings;
+        }
+        if (crossings == most_crossings)
+        {
+            most_crossing.push_back(i);
+        }
+    }
+
+    if (most_crossing.size() == 1)
+        return most_crossing.front();
+
+    std::size_t chosen = most_crossing.front();
+    double most_open = -1;
+    // number of placements tied with the chosen one, which is replaced by
+    // each of them with probability 1/ties, so that ties are broken uniformly
+    std::size_t ties = 0;
+    std::array<std::int_fast32_t, Alphabet::MAX_SIZE> open_counts;
+    for (std::size_t const i : most_crossing)
+    {
+        grid.place_word_unchecked(word, placements[i]);
+        grid.get_open_anchor_counts(open_counts);
+        grid.remove_last_word();
+        double open = 0;
+        for (std::size_t letter = 0; letter < open_counts.size(); letter++)
+        {
+            open += m_letter_frequency[letter] * open_counts[letter];
+        }
+
+        if (open > most_open)
+        {
+            chosen = i;
+            most_open = open;
+            ties = 1;
+        }
+        else if (open == most_open && std::uniform_int_distribution<std::size_t>(0, ties++)(rng) == 0)
+        {
+            chosen = i;
+        }
+    }
+    return chosen;
+}
@@ -0,0 +1,96 @@
+#pragma once
+
+#include <array>
+#include <random>
+#include <vector>
+
+#include "crossingindex.h"
+#include "grid.h"
+#include "word.h"
+
+namespace search {
+
+enum class FirstWordRule
+{
+    // any word that can cross another word
+    RANDOM,
+    // one of the words crossing the most other words
+    MOST_CONNECTED
+};
+
+enum class WordOrderRule
+{
+    RANDOM,
+    // long words with rare letters first, as they fit in the fewest places
+    HARDEST_FIRST
+};
+
+enum class PlacementRule
+{
+    RANDOM,
+    // One of the placements crossing the most words. Ties go to the placement
+    // leaving the most placed letters open for crossing further words.
+    MOST_CROSSINGS
+};
+
+/**
+    How the engines choose the first word, the order in which words are
+    tried and the placement of a word among its valid placements.
+ */
+typedef struct HeuristicSettings
+{
+    FirstWordRule first_word;
+    WordOrderRule word_order;
+    PlacementRule placement;
+} HeuristicSettings;
+
+/**
+    Word and placement choices of the engines, following the configured
+    rules. The per-word data the rules need is computed once after the words
+    are loaded and only read afterwards, so all workers share it.
+ */
+class Heuristics
+{
+private:
+    // number of words the first word is picked from with FirstWordRule::MOST_CONNECTED
+    static constexpr std::size_t FIRST_WORD_CANDIDATES = 8;
+
+    HeuristicSettings m_settings = { FirstWordRule::RANDOM, WordOrderRule::RANDOM, PlacementRule::RANDOM };
+    // 1 if the word may be the first word of a grid
+    std::vector<char> m_first_word_candidates;
+    // Information content of the word's letters, i.e. the sum of -log2 of
+    // their relative frequencies. Grows with the length and the rarity of the letters.
+    std::vector<double> m_difficulty;
+    // relative frequency of every letter over all words
+    std::array<double, Alphabet::MAX_SIZE> m_letter_frequency = {};
+
+public:
+    Heuristics() = default;
+    Heuristics(HeuristicSettings const &settings, WordStore const &words, CrossingIndex const &crossings);
+
+    HeuristicSettings const & get_settings() const;
+
+    /**
+        Checks if the word may be the first word of a grid. Never true for a
+        word that cannot cross any other word, which would leave the grid at one word.
+     */
+    bool is_first_word_candidate(wid word) const;
+
+    /**
+        Brings 'words' into the order in which they are tried. With
+        WordOrderRule::RANDOM this is a shuffle.
+     */
+    void order_words(std::vector<wid> &words, std::default_random_engine &rng) const;
+
+    /**
+        Chooses one of the valid placements 'placements' of the word on the
+        grid. MOST_CROSSINGS tries the placements crossing the most words on
+        the grid and counts the open letters afterwards, see
+        Grid::get_open_anchor_counts(), each by its frequency over all words.
+        @return the index of the chosen placement, 'placements' must not be empty
+     */
+    std::size_t choose_placement(grid::Grid &grid, wid word, std::vector<grid::Location> const &placements,
+                                 std::default_random_engine &rng) const;
+};
+
+} // namespace search
@@ -39,7 +39,7 @@ void LatexGenerator::add_puzzle(grid::Grid const * const grid, std::ofstream &of
        << grid->get_width()  + 1 << "}{" << grid->get_height() + 1 << "}" << std::endl;
 
     // lambda to construct a single cell string
-    auto fill_cell = [&, grid] (std::ofstream &of, char cell_content,
+    auto fill_cell = [&, grid] (std::ofstream &of, grid::gidx row, grid::gidx column,
                                 std::int_fast32_t vert_marker, std::int_fast32_t hori_marker)
              {
                  of << "|";
@@ -55,13 +55,13 @@ void LatexGenerator::add_puzzle(grid::Grid const * const grid, std::ofstream &of
                      of << "$]";
                  }
 
-                 if (cell_content == grid::Grid::EMPTY_CHAR)
+                 if (grid->get_cell_content(row, column) == grid::Grid::EMPTY_CHAR)
                  {
                      of << "{}";
                  }
                  else
                  {
-                     of << " " << cell_content;
+                     of << " " << grid->get_cell_glyph(row, column);
                  }
              };
 
@@ -70,14 +70,14 @@ void LatexGenerator::add_puzzle(grid::Grid const * const grid, std::ofstream &of
     {
         for (auto j = 0; j <= grid->get_width(); j++)
         {
-            Word const *vword = grid->get_word_starting_at(i, j -1, grid::Direction::VERTICAL);
-            Word const *hword = grid->get_word_starting_at(i - 1, j, grid::Direction::HORIZONTAL);
+            wid const *vword = grid->get_word_starting_at(i, j -1, grid::Direction::VERTICAL);
+            wid const *hword = grid->get_word_starting_at(i - 1, j, grid::Direction::HORIZONTAL);
             auto vmarker = 0, hmarker = 0;
             if (vword != nullptr)
                 vmarker = ++vert_count;
             if (hword != nullptr)
                 hmarker = ++hori_count;
-            fill_cell(of, grid->get_cell_content(i - 1, j - 1), vmarker, hmarker);
+            fill_cell(of, i - 1, j - 1, vmarker, hmarker);
         }
         of << "|." << std::endl;
     }
@@ -93,10 +93,10 @@ void LatexGenerator::add_hints(grid::Grid const * const grid, std::ofstream &of)
     {
         for (auto j = 0; j <= grid->get_width(); j++)
         {
-            Word const *vword = grid->get_word_starting_at(i, j, grid::Direction::VERTICAL);
+            wid const *vword = grid->get_word_starting_at(i, j, grid::Direction::VERTICAL);
             if (vword != nullptr)
             {
-                of << "\\item " << vword->clue << std::endl;
+                of << "\\item " << grid->get_word_store().clue(*vword) << std::endl;
             }
         }
     }
@@ -110,10 +110,10 @@ void LatexGenerator::add_hints(grid::Grid const * const grid, std::ofstream &of)
     {
         for (auto j = 0; j <= grid->get_width(); j++)
         {
-            Word const *vword = grid->get_word_starting_at(i, j, grid::Direction::HORIZONTAL);
+            wid const *vword = grid->get_word_starting_at(i, j, grid::Direction::HORIZONTAL);
             if (vword != nullptr)
             {
-                of << "\\item " << vword->clue << std::endl;
+                of << "\\item " << grid->get_word_store().clue(*vword) << std::endl;
             }
         }
     }
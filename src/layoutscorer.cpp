@@ -0,0 +1,31 @@
+#include <iostream>
+#include <sstream>
+
+#include "layoutscorer.h"
+
+using namespace scoring;
+
+LayoutScorerPolicy::LayoutScorerPolicy(INIReader const &config) :
+    m_base_score(config.GetInteger("scoring", "base_score", 0)),
+    m_placed_word_bonus(config.GetInteger("scoring", "placed_word_bonus", 0)),
+    m_word_crossing_bonus(config.GetInteger("scoring", "word_crossing_bonus", 0)),
+    m_missing_word_penalty(config.GetInteger("scoring", "missing_word_penalty", 0)),
+    m_density_bonus(config.GetInteger("scoring", "density_bonus", 0)),
+    m_island_penalty(config.GetInteger("scoring", "island_penalty", 0)),
+    m_uncrossed_run_penalty(config.GetInteger("scoring", "uncrossed_run_penalty", 0)),
+    m_imbalance_penalty(config.GetInteger("scoring", "imbalance_penalty", 0))
+{
+    std::ostringstream os;
+
+    os << "Initialized layout scorer with the following parameters" << std::endl;
+    os << "base_score = " << m_base_score << std::endl;
+    os << "placed_word_bonus = " << m_placed_word_bonus << std::endl;
+    os << "word_crossing_bonus = " << m_word_crossing_bonus << std::endl;
+    os << "missing_word_penalty = " << m_missing_word_penalty << std::endl;
+    os << "density_bonus = " << m_density_bonus << std::endl;
+    os << "island_penalty = " << m_island_penalty << std::endl;
+    os << "uncrossed_run_penalty = " << m_uncrossed_run_penalty << std::endl;
+    os << "imbalance_penalty = " << m_imbalance_penalty << std::endl;
+
+    std::cout << os.str();
+}
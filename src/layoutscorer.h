@@ -0,0 +1,83 @@
+#pragma once
+
+#include <algorithm>
+
+#include "scorer.h"
+
+#include "INIReader.h"
+
+namespace scoring {
+
+/**
+    Scorer policy of the word and crossing counts together with the layout
+    of the grid, see grid::Grid::get_layout_metrics(): the share of the used
+    cells holding a letter, the islands besides the main one, the longest
+    run of letters without a crossing and how unevenly the letters are
+    spread over the rows and columns. See PolicyScorer.
+ */
+class LayoutScorerPolicy
+{
+private:
+    score m_base_score;
+    score m_placed_word_bonus;
+    score m_word_crossing_bonus;
+    score m_missing_word_penalty;
+    // per percent of the used cells holding a letter
+    score m_density_bonus;
+    // per island besides the first one
+    score m_island_penalty;
+    // per letter of the longest uncrossed run
+    score m_uncrossed_run_penalty;
+    // per letter of the row and of the column imbalance
+    score m_imbalance_penalty;
+
+public:
+    LayoutScorerPolicy(INIReader const &config);
+
+    score score_grid(grid::Grid const &grid, std::int_fast32_t unplaced_word_count) const
+    {
+        grid::LayoutMetrics metrics;
+        grid.get_layout_metrics(metrics);
+
+        score result = m_base_score - m_missing_word_penalty * unplaced_word_count;
+        result += grid.get_placed_word_count() * m_placed_word_bonus;
+        result += grid.get_word_crossing_count() * m_word_crossing_bonus;
+        result += 100 * metrics.letter_count / metrics.area * m_density_bonus;
+        result -= std::max<score>(metrics.island_count - 1, 0) * m_island_penalty;
+        result -= metrics.longest_uncrossed_run * m_uncrossed_run_penalty;
+        result -= (metrics.row_imbalance + metrics.column_imbalance) * m_imbalance_penalty;
+
+        return result;
+    }
+
+    score upper_bound(grid::Grid const &grid, std::int_fast32_t unplaced_word_count,
+                      std::int_fast32_t placeable_word_count, std::int_fast32_t placeable_letter_count) const
+    {
+        // The word and crossing terms are bounded as by SimpleScorerPolicy.
+        // The layout changes with every further word, so the layout terms are
+        // bounded by their best value on any grid, without measuring this one.
+        score const per_word = m_missing_word_penalty + m_placed_word_bonus
+                               + std::min<score>(m_word_crossing_bonus, 0);
+        score result = m_base_score - m_missing_word_penalty * unplaced_word_count;
+        result += grid.get_placed_word_count() * m_placed_word_bonus;
+        result += grid.get_word_crossing_count() * m_word_crossing_bonus;
+        result += std::max<score>(per_word, 0) * placeable_word_count;
+        result += std::max<score>(m_word_crossing_bonus, 0) * placeable_letter_count;
+
+        result += 100 * std::max<score>(m_density_bonus, 0);
+        // negative penalties reward the worst layouts, which are at most as
+        // bad as every word on its own island or all letters in one run
+        score const words = grid.get_placed_word_count() + placeable_word_count;
+        score const letters = grid.get_placed_letter_count() + placeable_letter_count;
+        result -= std::min<score>(m_island_penalty, 0) * std::max<score>(words - 1, 0);
+        result -= std::min<score>(m_uncrossed_run_penalty, 0)
+                  * std::max(grid.get_max_height(), grid.get_max_width());
+        result -= std::min<score>(m_imbalance_penalty, 0) * 4 * letters;
+
+        return result;
+    }
+};
+
+typedef PolicyScorer<LayoutScorerPolicy> LayoutScorer;
+
+} // namespace score
@@ -0,0 +1,47 @@
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "mappedfile.h"
+
+MappedFile::MappedFile(std::string const &location) :
+    m_data(MAP_FAILED)
+{
+    int const fd = open(location.c_str(), O_RDONLY);
+    if (fd < 0)
+        return;
+
+    struct stat info;
+    if (fstat(fd, &info) == 0)
+    {
+        m_size = info.st_size;
+        // mmap() refuses empty mappings
+        m_open = m_size == 0
+                 || (m_data = mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, fd, 0)) != MAP_FAILED;
+    }
+    close(fd);
+}
+
+MappedFile::~MappedFile()
+{
+    if (m_data != MAP_FAILED)
+    {
+        munmap(m_data, m_size);
+    }
+}
+
+bool MappedFile::is_open() const
+{
+    return m_open;
+}
+
+char const * MappedFile::data() const
+{
+    return m_data != MAP_FAILED ? static_cast<char const *>(m_data) : nullptr;
+}
+
+std::size_t MappedFile::size() const
+{
+    return m_open ? m_size : 0;
+}
@@ -0,0 +1,29 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+/**
+    Read-only mapping of a whole file into memory, unmapped on destruction.
+    Like std::ifstream, a file that cannot be opened is reported through
+    is_open() instead of an exception. An empty file maps to no data.
+ */
+class MappedFile
+{
+private:
+    void *m_data;
+    std::size_t m_size = 0;
+    bool m_open = false;
+
+public:
+    MappedFile(std::string const &location);
+    ~MappedFile();
+
+    MappedFile(MappedFile const &) = delete;
+    MappedFile & operator=(MappedFile const &) = delete;
+
+    bool is_open() const;
+
+    char const * data() const;
+    std::size_t size() const;
+};
@@ -0,0 +1,80 @@
+#include <algorithm>
+
+#include "patternindex.h"
+
+static constexpr std::size_t BLOCK_BITS = 64;
+
+PatternIndex::PatternIndex(WordStore const &words) :
+    m_words(&words), m_block_count((words.size() + BLOCK_BITS - 1) / BLOCK_BITS)
+{
+    WordStore::Tables const &tables = words.tables();
+    std::size_t const alphabet_size = words.alphabet().size();
+    for (std::int_fast16_t p = 0; p < words.max_length(); p++)
+    {
+        // only words longer than p have a letter at p
+        m_first_block.push_back(tables.length_offsets[p + 1] / BLOCK_BITS);
+        m_position_offsets.push_back(m_bits.size());
+        m_bits.resize(m_bits.size() + alphabet_size * (m_block_count - m_first_block[p]), 0);
+    }
+
+    WordRange const all = words.words_of_length(0, words.max_length());
+    for (std::size_t i = 0; i < all.size(); i++)
+    {
+        std::string_view const letters = words.letters(all.first[i]);
+        for (std::size_t p = 0; p < letters.size(); p++)
+        {
+            std::size_t const blocks = m_block_count - m_first_block[p];
+            std::size_t const bit = i - m_first_block[p] * BLOCK_BITS;
+            m_bits[m_position_offsets[p] + static_cast<unsigned char>(letters[p]) * blocks + bit / BLOCK_BITS]
+                |= std::uint64_t(1) << (bit % BLOCK_BITS);
+        }
+    }
+}
+
+void PatternIndex::find(std::int_fast16_t min_length, std::int_fast16_t max_length,
+                        std::vector<LetterAt> const &letters, std::vector<wid> &buffer) const
+{
+    WordRange const range = m_words->words_of_length(min_length, max_length);
+    wid const *by_length = m_words->tables().by_length;
+    std::size_t first = range.first - by_length;
+    std::size_t const last = range.last - by_length;
+
+    std::vector<std::uint64_t const *> bitsets;
+    for (LetterAt const &letter : letters)
+    {
+        if (letter.position >= m_first_block.size()
+            || static_cast<unsigned char>(letter.letter) >= m_words->alphabet().size())
+            return;
+        // the shortest words of the range may be too short for the letter
+        first = std::max<std::size_t>(first, m_words->tables().length_offsets[letter.position + 1]);
+        std::size_t const blocks = m_block_count - m_first_block[letter.position];
+        // offset so that block b of all words is bitsets.back()[b]
+        bitsets.push_back(m_bits.data() + m_position_offsets[letter.position]
+                          + static_cast<unsigned char>(letter.letter) * blocks - m_first_block[letter.position]);
+    }
+    if (first >= last)
+        return;
+
+    for (std::size_t block = first / BLOCK_BITS; block <= (last - 1) / BLOCK_BITS; block++)
+    {
+        std::uint64_t match = ~std::uint64_t(0);
+        if (block == first / BLOCK_BITS)
+            match &= ~std::uint64_t(0) << (first % BLOCK_BITS);
+        if (block == (last - 1) / BLOCK_BITS)
+            match &= ~std::uint64_t(0) >> (BLOCK_BITS - 1 - (last - 1) % BLOCK_BITS);
+        for (std::uint64_t const *bitset : bitsets)
+        {
+            match &= bitset[block];
+        }
+        while (match != 0)
+        {
+            buffer.push_back(by_length[block * BLOCK_BITS + __builtin_ctzll(match)]);
+            match &= match - 1;
+        }
+    }
+}
+
+std::size_t PatternIndex::memory_size() const
+{
+    return m_bits.size() * sizeof(std::uint64_t);
+}
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "word.h"
+
+/**
+    Index of the words of a WordStore by length and by the letter at each
+    position, for looking up words fitting a gap of the grid in large word
+    lists. Words are numbered in the store's length order (see
+    WordStore::words_of_length()). There is one bitset over these numbers per
+    (position, letter), so a pattern is matched by ANDing one bitset per
+    given letter over the range of lengths. A bitset only covers the words
+    longer than its position.
+ */
+class PatternIndex
+{
+public:
+    typedef struct LetterAt
+    {
+        std::uint16_t position;
+        // alphabet code
+        char letter;
+    } LetterAt;
+
+private:
+    WordStore const *m_words = nullptr;
+    // first 64 bit block of the bitsets of position p, as counted over all words
+    std::vector<std::size_t> m_first_block;
+    // the bitset of (p, letter) starts at m_bits[m_position_offsets[p] + letter * block count of p]
+    std::vector<std::size_t> m_position_offsets;
+    std::vector<std::uint64_t> m_bits;
+    std::size_t m_block_count = 0;
+
+public:
+    PatternIndex() = default;
+
+    /**
+        Builds the index of 'words', which must outlive the index and have
+        its length tables built.
+     */
+    PatternIndex(WordStore const &words);
+
+    /**
+        Appends the words with a length in [min_length, max_length] that have
+        all of the given letters at the given positions to buffer, shortest first.
+     */
+    void find(std::int_fast16_t min_length, std::int_fast16_t max_length, std::vector<LetterAt> const &letters,
+              std::vector<wid> &buffer) const;
+
+    /**
+        Size of the bitsets in bytes.
+     */
+    std::size_t memory_size() const;
+};
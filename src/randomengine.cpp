@@ -0,0 +1,100 @@
+#include <algorithm>
+
+#include "layoutscorer.h"
+#include "randomengine.h"
+#include "simplescorer.h"
+
+using namespace search;
+
+template<typename ScorerPolicy>
+void RandomEngine<ScorerPolicy>::fill_grid(grid::Grid &grid, WordStore const &words,
+                                           Context<ScorerPolicy> &context) const
+{
+    std::uniform_int_distribution<int> dist(0, 1); // for generating random vert/horizontal
+    std::vector<wid> unused_words(words.size());
+    for (std::size_t i = 0; i < words.size(); i++)
+    {
+        unused_words[i] = i;
+    }
+
+    // place random first word
+    std::shuffle(std::begin(unused_words), std::end(unused_words), context.rng);
+    Engine::prefer_first_word_last(unused_words, context.heuristics);
+    wid const first_word = unused_words.back();
+    grid::Direction const first_dir = static_cast<grid::Direction>(dist(context.rng));
+
+    grid.place_first_word(first_word, first_dir);
+    unused_words.pop_back();
+
+    // A word that did not fit can only fit later on crossing a word placed
+    // in the meantime. retry[w] is true if such a word has been placed since
+    // w did not fit, or if w was not tried yet.
+    std::vector<char> retry(words.size());
+    // words that can cross another word and are not placed yet, which are
+    // all the words that may still be placed
+    std::int_fast32_t placeable_words = 0;
+    std::int_fast32_t placeable_letters = 0;
+    for (wid id = 0; id < words.size(); id++)
+    {
+        retry[id] = context.crossings.can_cross(id);
+        if (retry[id] && id != first_word)
+        {
+            placeable_words++;
+            placeable_letters += words.length(id);
+        }
+    }
+
+    // in every iteration, order not yet placed words and try to add them at
+    // a valid location chosen by the heuristics, in that order. Repeat until
+    // no words are left or no remaining word can be placed.
+    while (unused_words.size() != 0)
+    {
+        bool word_placed = false;
+        context.heuristics.order_words(unused_words, context.rng);
+
+        std::vector<wid> unplaced_words;
+        for (auto const &word : unused_words)
+        {
+            if (!retry[word])
+            {
+                unplaced_words.push_back(word);
+                continue;
+            }
+
+            std::vector<grid::Location> valid_placements;
+            grid.get_valid_placements(word, valid_placements);
+            if (valid_placements.size() == 0)
+            {
+                unplaced_words.push_back(word);
+                retry[word] = false;
+            }
+            else
+            {
+                grid::Location const loc = valid_placements[
+                    context.heuristics.choose_placement(grid, word, valid_placements, context.rng)];
+                grid.place_word_unchecked(word, loc);
+                word_placed = true;
+                for (wid const other : context.crossings.crossing_words(word))
+                {
+                    retry[other] = true;
+                }
+
+                placeable_words--;
+                placeable_letters -= words.length(word);
+                if (this->is_hopeless(grid, words.size() - grid.get_placed_word_count(), placeable_words,
+                                      placeable_letters, context))
+                {
+                    context.abandoned = true;
+                    return;
+                }
+            }
+        }
+        unused_words = std::move(unplaced_words);
+
+        if (!word_placed)
+            break;
+    }
+}
+
+template class search::RandomEngine<scoring::SimpleScorerPolicy>;
+template class search::RandomEngine<scoring::LayoutScorerPolicy>;
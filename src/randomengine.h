@@ -0,0 +1,20 @@
+#pragma once
+
+#include "engine.h"
+
+namespace search {
+
+/**
+    Places a first word and then adds the remaining words at valid locations
+    until no word fits anymore. The first word, the order of the words and
+    the locations are random, unless other heuristics are configured. The
+    restart is abandoned as soon as its grid cannot get into the result pool.
+ */
+template<typename ScorerPolicy>
+class RandomEngine : public BasicEngine<ScorerPolicy>
+{
+public:
+    void fill_grid(grid::Grid &grid, WordStore const &words, Context<ScorerPolicy> &context) const override;
+};
+
+} // namespace search
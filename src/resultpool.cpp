@@ -0,0 +1,138 @@
+#include <algorithm>
+#include <limits>
+
+#include "resultpool.h"
+
+using namespace snapshot;
+
+// A placement as a single number, which sorts and compares quickly.
+// Locations are relative to the used bounds, thus below 2^15.
+static std::uint64_t placement_key(GridSnapshot::PlacedWord const &placed)
+{
+    return (static_cast<std::uint64_t>(placed.word) << 32) | (static_cast<std::uint64_t>(placed.loc.row) << 16)
+           | (static_cast<std::uint64_t>(placed.loc.column) << 1) | static_cast<std::uint64_t>(placed.loc.direction);
+}
+
+ResultPool::ResultPool(std::size_t capacity, std::int_fast32_t min_difference) :
+    m_capacity(capacity), m_min_difference(std::max<std::int_fast32_t>(min_difference, 1))
+{
+}
+
+bool ResultPool::is_better(Entry const &lhs, Entry const &rhs)
+{
+    if (lhs.snapshot.grid_score != rhs.snapshot.grid_score)
+        return lhs.snapshot.grid_score > rhs.snapshot.grid_score;
+    return lhs.sequence < rhs.sequence;
+}
+
+std::int_fast32_t ResultPool::difference(std::vector<std::uint64_t> const &lhs,
+                                         std::vector<std::uint64_t> const &rhs)
+{
+    std::int_fast32_t shared = 0;
+    for (auto l = lhs.begin(), r = rhs.begin(); l != lhs.end() && r != rhs.end();)
+    {
+        if (*l < *r)
+        {
+            ++l;
+        }
+        else if (*r < *l)
+        {
+            ++r;
+        }
+        else
+        {
+            shared++;
+            ++l;
+            ++r;
+        }
+    }
+    return lhs.size() + rhs.size() - 2 * shared;
+}
+
+bool ResultPool::accepts(scoring::score grid_score) const
+{
+    // a new grid loses ties against the grids already in the pool
+    return m_capacity > 0 && (m_heap.size() < m_capacity || grid_score > m_heap.front().snapshot.grid_score);
+}
+
+scoring::score ResultPool::get_threshold() const
+{
+    if (m_heap.size() < m_capacity)
+        return std::numeric_limits<scoring::score>::min();
+    return m_capacity > 0 ? m_heap.front().snapshot.grid_score : std::numeric_limits<scoring::score>::max();
+}
+
+bool ResultPool::add(GridSnapshot const &snapshot)
+{
+    if (!accepts(snapshot.grid_score))
+        return false;
+
+    Entry entry = { snapshot, {}, m_next_sequence };
+    for (auto const &placed : snapshot.words)
+    {
+        entry.placements.push_back(placement_key(placed));
+    }
+    std::sort(entry.placements.begin(), entry.placements.end());
+
+    std::vector<std::size_t> beaten;
+    for (std::size_t i = 0; i < m_heap.size(); i++)
+    {
+        Entry const &kept = m_heap[i];
+        // equal hashes are the same grid, which needs no comparison
+        if (kept.snapshot.hash != snapshot.hash
+            && difference(kept.placements, entry.placements) >= m_min_difference)
+            continue;
+        if (is_better(kept, entry))
+            return false;
+        beaten.push_back(i);
+    }
+    m_next_sequence++;
+
+    // ordering the heap by is_better() puts the worst grid at its front
+    auto const better = [](Entry const &lhs, Entry const &rhs) { return is_better(lhs, rhs); };
+    if (!beaten.empty())
+    {
+        for (auto it = beaten.rbegin(); it != beaten.rend(); ++it)
+        {
+            m_heap.erase(m_heap.begin() + *it);
+        }
+        std::make_heap(m_heap.begin(), m_heap.end(), better);
+    }
+    m_heap.push_back(std::move(entry));
+    std::push_heap(m_heap.begin(), m_heap.end(), better);
+    if (m_heap.size() > m_capacity)
+    {
+        std::pop_heap(m_heap.begin(), m_heap.end(), better);
+        m_heap.pop_back();
+    }
+    return true;
+}
+
+void ResultPool::clear()
+{
+    m_heap.clear();
+    m_next_sequence = 0;
+}
+
+std::size_t ResultPool::size() const
+{
+    return m_heap.size();
+}
+
+std::vector<GridSnapshot> ResultPool::best_first() const
+{
+    std::vector<Entry const *> entries;
+    for (auto const &entry : m_heap)
+    {
+        entries.push_back(&entry);
+    }
+    std::sort(entries.begin(), entries.end(),
+              [](Entry const *lhs, Entry const *rhs) { return is_better(*lhs, *rhs); });
+
+    std::vector<GridSnapshot> result;
+    for (Entry const *entry : entries)
+    {
+        result.push_back(entry->snapshot);
+    }
+    return result;
+}
@@ -0,0 +1,81 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "grid.h"
+#include "scorer.h"
+#include "snapshot.h"
+
+namespace snapshot {
+
+/**
+    The best distinct grids of a run, at most 'capacity' of them. Grids are
+    kept as snapshots, i.e. word ids and locations, so a large pool costs
+    little memory. Two grids are similar if fewer than 'min_difference' of
+    their words are not placed at the same place in the other one, relative
+    to the used bounds. Of similar grids, only the better one is kept, so
+    the pool never holds the same grid twice. Not thread-safe.
+ */
+class ResultPool
+{
+private:
+    typedef struct Entry
+    {
+        GridSnapshot snapshot;
+        // the snapshot's placements packed by placement_key(), sorted
+        std::vector<std::uint64_t> placements;
+        // order in which the grids were added, earlier grids win ties
+        std::uint64_t sequence;
+    } Entry;
+
+    std::size_t m_capacity;
+    std::int_fast32_t m_min_difference;
+    std::uint64_t m_next_sequence = 0;
+    // min-heap, the worst grid is at the front
+    std::vector<Entry> m_heap;
+
+    // true if lhs is the better grid, i.e. has the higher score or was added earlier
+    static bool is_better(Entry const &lhs, Entry const &rhs);
+
+    /**
+        Number of placements of either grid that the other grid does not have.
+        Both are sorted, so this is a merge.
+     */
+    static std::int_fast32_t difference(std::vector<std::uint64_t> const &lhs,
+                                        std::vector<std::uint64_t> const &rhs);
+
+public:
+    ResultPool(std::size_t capacity, std::int_fast32_t min_difference);
+
+    /**
+        Checks if a grid with the given score may get into the pool, so that
+        it only needs to be captured if so.
+     */
+    bool accepts(scoring::score grid_score) const;
+
+    /**
+        @return the score a grid must beat to get into the pool whatever its
+        words: the worst kept score once the pool is full, the lowest score
+        before
+     */
+    scoring::score get_threshold() const;
+
+    /**
+        Adds a grid unless the pool holds a similar grid that is at least as
+        good. The similar grids it beats are dropped, as is the worst grid
+        if the pool is over capacity.
+        @return if the grid was added
+     */
+    bool add(GridSnapshot const &snapshot);
+
+    void clear();
+    std::size_t size() const;
+
+    /**
+        @return the grids of the pool, best first
+     */
+    std::vector<GridSnapshot> best_first() const;
+};
+
+} // namespace snapshot
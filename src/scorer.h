@@ -1,13 +1,9 @@
 #pragma once
 
-#include <memory>
-#include <string>
 #include <cstdint>
 
 #include "grid.h"
 
-#include "INIReader.h"
-
 namespace scoring {
 
 typedef std::int_fast32_t score;
@@ -15,10 +11,63 @@ typedef std::int_fast32_t score;
 class Scorer
 {
 public:
-    static std::unique_ptr<Scorer> create(std::string const &type, INIReader const &config);
+    virtual ~Scorer() = default;
 
+    /**
+        Scores a grid. Note that the generator calls this concurrently from all
+        of its worker threads, so implementations must not modify shared state.
+     */
     virtual score score_grid(grid::Grid const &grid,
                              std::int_fast32_t unplaced_word_count) const = 0;
+
+    /**
+        Optimistic bound for search engines: no grid that 'grid' can be
+        extended to by placing more words scores higher than this. The
+        placeable words are the unplaced words that may still fit on the
+        grid, 'placeable_letter_count' is their total length. Only O(1)
+        getters of the grid may be used, as engines call this for every
+        partial grid. Called concurrently like score_grid().
+     */
+    virtual score upper_bound(grid::Grid const &grid, std::int_fast32_t unplaced_word_count,
+                              std::int_fast32_t placeable_word_count,
+                              std::int_fast32_t placeable_letter_count) const = 0;
+};
+
+/**
+    Scorer interface of a scorer policy. A policy is a class with the
+    score_grid() and upper_bound() functions of Scorer, but not virtual and
+    defined in its header. The generator and the search engines are
+    instantiated per policy and call the policy directly, so the scoring is
+    inlined into them. This adapter is for code that sees all policies alike.
+ */
+template<typename Policy>
+class PolicyScorer : public Scorer
+{
+private:
+    Policy m_policy;
+
+public:
+    explicit PolicyScorer(Policy const &policy) :
+        m_policy(policy)
+    {
+    }
+
+    Policy const & policy() const
+    {
+        return m_policy;
+    }
+
+    score score_grid(grid::Grid const &grid, std::int_fast32_t unplaced_word_count) const override
+    {
+        return m_policy.score_grid(grid, unplaced_word_count);
+    }
+
+    score upper_bound(grid::Grid const &grid, std::int_fast32_t unplaced_word_count,
+                      std::int_fast32_t placeable_word_count,
+                      std::int_fast32_t placeable_letter_count) const override
+    {
+        return m_policy.upper_bound(grid, unplaced_word_count, placeable_word_count, placeable_letter_count);
+    }
 };
 
 } // namespace score
\ No newline at end of file
@@ -0,0 +1,90 @@
+#include <cstdint>
+
+#include "segmentmatch.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#define SEGMENT_MATCH_X86
+#include <immintrin.h>
+#endif
+
+using namespace grid;
+
+static bool segment_matches_scalar(char const *cells, char const *letters,
+                                   std::size_t length, char empty)
+{
+    bool conflict = false;
+    for (std::size_t i = 0; i < length; i++)
+    {
+        conflict |= cells[i] != empty && cells[i] != letters[i];
+    }
+    return !conflict;
+}
+
+#ifdef SEGMENT_MATCH_X86
+
+// mask of the lowest 'count' bits, count may be larger than the mask width
+static inline std::uint32_t low_bits(std::size_t count)
+{
+    return count >= 32 ? ~std::uint32_t(0) : (std::uint32_t(1) << count) - 1;
+}
+
+__attribute__((target("sse2")))
+static bool segment_matches_sse2(char const *cells, char const *letters,
+                                 std::size_t length, char empty)
+{
+    __m128i const empties = _mm_set1_epi8(empty);
+    for (std::size_t i = 0; i < length; i += 16)
+    {
+        __m128i const c = _mm_loadu_si128(reinterpret_cast<__m128i const *>(cells + i));
+        __m128i const l = _mm_loadu_si128(reinterpret_cast<__m128i const *>(letters + i));
+        __m128i const ok = _mm_or_si128(_mm_cmpeq_epi8(c, empties), _mm_cmpeq_epi8(c, l));
+        std::uint32_t const bad = ~static_cast<std::uint32_t>(_mm_movemask_epi8(ok)) & 0xFFFF;
+        if (bad & low_bits(length - i))
+            return false;
+    }
+    return true;
+}
+
+__attribute__((target("avx2")))
+static bool segment_matches_avx2(char const *cells, char const *letters,
+                                 std::size_t length, char empty)
+{
+    __m256i const empties = _mm256_set1_epi8(empty);
+    for (std::size_t i = 0; i < length; i += 32)
+    {
+        __m256i const c = _mm256_loadu_si256(reinterpret_cast<__m256i const *>(cells + i));
+        __m256i const l = _mm256_loadu_si256(reinterpret_cast<__m256i const *>(letters + i));
+        __m256i const ok = _mm256_or_si256(_mm256_cmpeq_epi8(c, empties), _mm256_cmpeq_epi8(c, l));
+        std::uint32_t const bad = ~static_cast<std::uint32_t>(_mm256_movemask_epi8(ok));
+        if (bad & low_bits(length - i))
+            return false;
+    }
+    return true;
+}
+
+#endif // SEGMENT_MATCH_X86
+
+static SegmentMatchFunction select_segment_match()
+{
+#ifdef SEGMENT_MATCH_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2"))
+        return segment_matches_avx2;
+    if (__builtin_cpu_supports("sse2"))
+        return segment_matches_sse2;
+#endif
+    return segment_matches_scalar;
+}
+
+SegmentMatchFunction const grid::segment_matches = select_segment_match();
+
+char const * grid::segment_match_implementation()
+{
+#ifdef SEGMENT_MATCH_X86
+    if (segment_matches == segment_matches_avx2)
+        return "avx2";
+    if (segment_matches == segment_matches_sse2)
+        return "sse2";
+#endif
+    return "scalar";
+}
@@ -0,0 +1,31 @@
+#pragma once
+
+#include <cstddef>
+
+namespace grid {
+
+/**
+    Number of bytes that segment_matches() may read past the end of both
+    the cells and the letters it is given.
+ */
+constexpr std::size_t SEGMENT_MATCH_PADDING = 32;
+
+typedef bool (*SegmentMatchFunction)(char const *cells, char const *letters,
+                                     std::size_t length, char empty);
+
+/**
+    Checks if the letters can be written over a contiguous run of grid cells,
+    i.e. if every cell is either empty or already holds the same letter.
+
+    Points to an AVX2, SSE2 or scalar implementation, chosen once at startup
+    depending on what the CPU supports. Note that the vector implementations
+    may read up to SEGMENT_MATCH_PADDING bytes past the end of both buffers.
+ */
+extern SegmentMatchFunction const segment_matches;
+
+/**
+    Name of the implementation segment_matches points to, for diagnostics.
+ */
+char const * segment_match_implementation();
+
+} // namespace grid
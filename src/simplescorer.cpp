@@ -5,7 +5,7 @@
 
 using namespace scoring;
 
-SimpleScorer::SimpleScorer(INIReader const &config) :
+SimpleScorerPolicy::SimpleScorerPolicy(INIReader const &config) :
     m_base_score(config.GetInteger("scoring", "base_score", 0)),
     m_placed_word_bonus(config.GetInteger("scoring", "placed_word_bonus", 0)),
     m_placed_letter_bonus(config.GetInteger("scoring", "placed_letter_bonus", 0)),
@@ -27,17 +27,3 @@ SimpleScorer::SimpleScorer(INIReader const &config) :
 
     std::cout << os.str();
 }
-
-score SimpleScorer::score_grid(grid::Grid const &grid,
-                                std::int_fast32_t unplaced_word_count) const
-{
-    score result = m_base_score - m_missing_word_penalty * unplaced_word_count;
-    result += grid.get_word_crossing_count() * m_word_crossing_bonus;
-    result += grid.get_placed_word_count() * m_placed_word_bonus;
-    // a crossing has the same letter of two words. This is not included in get_placed_letter_count
-    result += (grid.get_word_crossing_count() + grid.get_placed_letter_count()) * m_placed_letter_bonus;
-    result -= grid.get_width() * m_used_column_penalty;
-    result -= grid.get_height() * m_used_row_penalty;
-
-    return result;
-}
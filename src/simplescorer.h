@@ -1,12 +1,18 @@
 #pragma once
 
+#include <algorithm>
+
 #include "scorer.h"
 
 #include "INIReader.h"
 
 namespace scoring {
 
-class SimpleScorer : public Scorer
+/**
+    Scorer policy of a weighted sum of the grid's word, letter and crossing
+    counts and its used rows and columns, see PolicyScorer.
+ */
+class SimpleScorerPolicy
 {
 private:
     score m_base_score;
@@ -18,10 +24,45 @@ private:
     score m_used_column_penalty;
 
 public:
-    SimpleScorer(INIReader const &config);
+    SimpleScorerPolicy(INIReader const &config);
+
+    score score_grid(grid::Grid const &grid, std::int_fast32_t unplaced_word_count) const
+    {
+        score result = m_base_score - m_missing_word_penalty * unplaced_word_count;
+        result += grid.get_word_crossing_count() * m_word_crossing_bonus;
+        result += grid.get_placed_word_count() * m_placed_word_bonus;
+        // a crossing has the same letter of two words. This is not included in get_placed_letter_count
+        result += (grid.get_word_crossing_count() + grid.get_placed_letter_count()) * m_placed_letter_bonus;
+        result -= grid.get_width() * m_used_column_penalty;
+        result -= grid.get_height() * m_used_row_penalty;
+
+        return result;
+    }
 
-    score score_grid(grid::Grid const &grid,
-                     std::int_fast32_t unplaced_word_count) const override;
+    score upper_bound(grid::Grid const &grid, std::int_fast32_t unplaced_word_count,
+                      std::int_fast32_t placeable_word_count, std::int_fast32_t placeable_letter_count) const
+    {
+        // A further word of length l lifts the missing word penalty and adds l
+        // to the letter count including crossings. It crosses between 1 and l
+        // letters. Taking the best case of each part apart bounds every word,
+        // whatever its length.
+        score const per_word = m_missing_word_penalty + m_placed_word_bonus
+                               + std::min<score>(m_word_crossing_bonus, 0);
+        score const per_letter = m_placed_letter_bonus + std::max<score>(m_word_crossing_bonus, 0);
+        score result = score_grid(grid, unplaced_word_count);
+        result += std::max<score>(per_word, 0) * placeable_word_count;
+        result += std::max<score>(per_letter, 0) * placeable_letter_count;
+
+        // the used rows and columns can only grow
+        if (m_used_column_penalty < 0)
+            result -= (grid.get_max_width() - grid.get_width()) * m_used_column_penalty;
+        if (m_used_row_penalty < 0)
+            result -= (grid.get_max_height() - grid.get_height()) * m_used_row_penalty;
+
+        return result;
+    }
 };
 
-} // namespace score
\ No newline at end of file
+typedef PolicyScorer<SimpleScorerPolicy> SimpleScorer;
+
+} // namespace score
@@ -0,0 +1,369 @@
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <limits>
+#include <sstream>
+#include <stdexcept>
+
+#include "mappedfile.h"
+#include "snapshot.h"
+
+using namespace snapshot;
+
+namespace
+{
+
+// On-disk layout of a pool file, see PoolWriter
+
+constexpr char MAGIC[8] = { 'C', 'W', 'P', 'O', 'O', 'L', '\0', '\0' };
+constexpr std::uint32_t VERSION = 1;
+constexpr std::size_t RECORD_ALIGNMENT = 8;
+
+enum RecordType : std::uint32_t
+{
+    GRID_RECORD = 1,
+    CHECKPOINT_RECORD = 2
+};
+
+typedef struct FileHeader
+{
+    char magic[8];
+    std::uint32_t version;
+    std::uint32_t reserved;
+    std::uint64_t word_store_hash;
+    std::int32_t max_height;
+    std::int32_t max_width;
+} FileHeader;
+
+typedef struct RecordHeader
+{
+    std::uint32_t type;
+    // size of the record after this header, including the padding
+    std::uint32_t size;
+} RecordHeader;
+
+// followed by word_count PlacedWordRecords
+typedef struct GridRecord
+{
+    std::int64_t grid_score;
+    std::uint64_t hash;
+    std::int32_t height;
+    std::int32_t width;
+    std::uint32_t word_count;
+    std::uint32_t reserved;
+} GridRecord;
+
+typedef struct PlacedWordRecord
+{
+    std::uint32_t word;
+    // relative to the used bounds of the grid
+    std::uint16_t row;
+    std::uint16_t column;
+    std::uint32_t direction;
+} PlacedWordRecord;
+
+// followed by worker_count random generator states, each a std::uint32_t
+// length and the state's text
+typedef struct CheckpointRecord
+{
+    std::uint64_t rng_seed;
+    std::int64_t finished_restarts;
+    std::uint32_t grid_count;
+    std::uint32_t worker_count;
+} CheckpointRecord;
+
+static_assert(sizeof(FileHeader) == 32 && sizeof(RecordHeader) == 8 && sizeof(GridRecord) == 32
+              && sizeof(PlacedWordRecord) == 12 && sizeof(CheckpointRecord) == 24,
+              "pool file layout must not depend on the compiler");
+
+template<typename T>
+void append(std::string &buffer, T const &value)
+{
+    buffer.append(reinterpret_cast<char const *>(&value), sizeof(T));
+}
+
+// Appends a record. 'payload' writes the record's content to the buffer.
+template<typename F>
+void append_record(std::string &buffer, RecordType type, F payload)
+{
+    std::size_t const start = buffer.size();
+    append(buffer, RecordHeader{ type, 0 });
+    payload(buffer);
+    buffer.resize(start + (buffer.size() - start + RECORD_ALIGNMENT - 1) / RECORD_ALIGNMENT * RECORD_ALIGNMENT, '\0');
+
+    std::uint32_t const size = buffer.size() - start - sizeof(RecordHeader);
+    std::memcpy(&buffer[start] + offsetof(RecordHeader, size), &size, sizeof(size));
+}
+
+// Bounds checked reads from a mapped file
+class Reader
+{
+private:
+    char const *m_data;
+    std::size_t m_size;
+    std::string const &m_location;
+
+public:
+    Reader(char const *data, std::size_t size, std::string const &location) :
+        m_data(data), m_size(size), m_location(location)
+    {
+    }
+
+    bool has(std::size_t offset, std::size_t count) const
+    {
+        return offset <= m_size && count <= m_size - offset;
+    }
+
+    template<typename T>
+    T read(std::size_t &offset) const
+    {
+        if (!has(offset, sizeof(T)))
+            fail("unexpected end of record");
+        T value;
+        std::memcpy(&value, m_data + offset, sizeof(T));
+        offset += sizeof(T);
+        return value;
+    }
+
+    std::string read_string(std::size_t &offset, std::size_t length) const
+    {
+        if (!has(offset, length))
+            fail("unexpected end of record");
+        offset += length;
+        return std::string(m_data + offset - length, length);
+    }
+
+    [[noreturn]] void fail(std::string const &reason) const
+    {
+        throw std::runtime_error("Invalid pool file " + m_location + ": " + reason);
+    }
+};
+
+// File a checkpoint is written to before it replaces the pool file
+std::string temporary_location(std::string const &location)
+{
+    return location + ".tmp";
+}
+
+// Checks that a placed word of a snapshot is a known word in a known
+// direction that lies within the snapshot's used bounds.
+bool fits(GridSnapshot::PlacedWord const &placed, WordStore const &words, grid::gidx height, grid::gidx width)
+{
+    if (placed.word >= words.size() || placed.loc.row < 0 || placed.loc.column < 0
+        || (placed.loc.direction != grid::Direction::HORIZONTAL && placed.loc.direction != grid::Direction::VERTICAL))
+        return false;
+    bool const horizontal = placed.loc.direction == grid::Direction::HORIZONTAL;
+    grid::gidx const length = words.length(placed.word);
+    return placed.loc.row + (horizontal ? 1 : length) <= height && placed.loc.column + (horizontal ? length : 1) <= width;
+}
+
+} // namespace
+
+GridSnapshot snapshot::capture(grid::Grid const &grid, scoring::score grid_score)
+{
+    GridSnapshot snapshot = { grid_score, grid.get_hash(), grid.get_height(), grid.get_width(), {} };
+
+    std::vector<grid::Location> locations;
+    grid.get_placed_locations(locations);
+    // words start at the top/left of their cells, so the used bounds start at the smallest start
+    grid::gidx min_row = std::numeric_limits<grid::gidx>::max();
+    grid::gidx min_column = std::numeric_limits<grid::gidx>::max();
+    for (auto const &loc : locations)
+    {
+        min_row = std::min(min_row, loc.row);
+        min_column = std::min(min_column, loc.column);
+    }
+    for (auto const &loc : locations)
+    {
+        snapshot.words.push_back({ *grid.get_word_at(loc), { loc.row - min_row, loc.column - min_column,
+                                                             loc.direction } });
+    }
+    return snapshot;
+}
+
+void snapshot::restore(GridSnapshot const &snapshot, grid::Grid &grid)
+{
+    WordStore const &words = grid.get_word_store();
+    if (snapshot.height > grid.get_max_height() || snapshot.width > grid.get_max_width())
+        throw std::runtime_error("Grid snapshot does not fit the grid dimensions");
+
+    // any place leaving the used bounds within the internal grid will do, as
+    // locations are only meaningful relative to each other
+    grid::gidx const row_offset = grid.get_max_height() / 2;
+    grid::gidx const column_offset = grid.get_max_width() / 2;
+    for (auto const &placed : snapshot.words)
+    {
+        if (!fits(placed, words, snapshot.height, snapshot.width))
+            throw std::runtime_error("Grid snapshot refers to unknown words or locations");
+
+        grid.place_word_unchecked(placed.word, { placed.loc.row + row_offset, placed.loc.column + column_offset,
+                                                 placed.loc.direction });
+    }
+
+    // Words removed out of order may have left words that would no longer be
+    // valid placements, so the words are not checked against the placement
+    // rules but against each other's letters and the hash of the saved grid.
+    for (auto const &placed : snapshot.words)
+    {
+        bool const horizontal = placed.loc.direction == grid::Direction::HORIZONTAL;
+        std::string_view const letters = words.letters(placed.word);
+        for (std::size_t i = 0; i < letters.size(); i++)
+        {
+            if (grid.get_cell_content(placed.loc.row + (horizontal ? 0 : i),
+                                      placed.loc.column + (horizontal ? i : 0)) != letters[i])
+                throw std::runtime_error("Grid snapshot holds conflicting words");
+        }
+    }
+    if (grid.get_hash() != snapshot.hash)
+        throw std::runtime_error("Grid snapshot does not match its hash");
+}
+
+std::uint64_t snapshot::hash_word_store(WordStore const &words)
+{
+    // FNV-1a over all words and clues, each terminated by a 0 byte
+    std::uint64_t hash = 0xCBF29CE484222325ULL;
+    auto const add = [&hash](std::string_view text) {
+        for (char const c : text)
+        {
+            hash = (hash ^ static_cast<unsigned char>(c)) * 0x100000001B3ULL;
+        }
+        hash *= 0x100000001B3ULL;
+    };
+    for (wid id = 0; id < words.size(); id++)
+    {
+        add(words.letters(id));
+        add(words.clue(id));
+    }
+    return hash;
+}
+
+PoolWriter::PoolWriter(std::string const &location, WordStore const &words,
+                       grid::gidx max_height, grid::gidx max_width) :
+    m_location(location)
+{
+    if (!std::ofstream(temporary_location(location), std::ios::binary | std::ios::trunc).is_open())
+        throw std::runtime_error("Could not open pool file " + location + " for writing");
+    std::filesystem::remove(temporary_location(location));
+
+    FileHeader header = { {}, VERSION, 0, hash_word_store(words),
+                          static_cast<std::int32_t>(max_height), static_cast<std::int32_t>(max_width) };
+    std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+    append(m_header, header);
+}
+
+void PoolWriter::write(Checkpoint const &checkpoint)
+{
+    std::string buffer = m_header;
+    for (auto const &snapshot : checkpoint.pool)
+    {
+        append_record(buffer, GRID_RECORD, [&snapshot](std::string &out) {
+            append(out, GridRecord{ snapshot.grid_score, snapshot.hash, static_cast<std::int32_t>(snapshot.height),
+                                    static_cast<std::int32_t>(snapshot.width),
+                                    static_cast<std::uint32_t>(snapshot.words.size()), 0 });
+            for (auto const &placed : snapshot.words)
+            {
+                append(out, PlacedWordRecord{ placed.word, static_cast<std::uint16_t>(placed.loc.row),
+                                              static_cast<std::uint16_t>(placed.loc.column),
+                                              static_cast<std::uint32_t>(placed.loc.direction) });
+            }
+        });
+    }
+    append_record(buffer, CHECKPOINT_RECORD, [&checkpoint](std::string &out) {
+        append(out, CheckpointRecord{ checkpoint.rng_seed, checkpoint.finished_restarts,
+                                      static_cast<std::uint32_t>(checkpoint.pool.size()),
+                                      static_cast<std::uint32_t>(checkpoint.rng_states.size()) });
+        for (auto const &state : checkpoint.rng_states)
+        {
+            append(out, static_cast<std::uint32_t>(state.size()));
+            out.append(state);
+        }
+    });
+
+    std::string const temporary = temporary_location(m_location);
+    std::ofstream file(temporary, std::ios::binary | std::ios::trunc);
+    file.write(buffer.data(), buffer.size());
+    file.close();
+    std::error_code error;
+    if (!file || (std::filesystem::rename(temporary, m_location, error), error))
+        throw std::runtime_error("Could not write to pool file " + m_location);
+}
+
+Checkpoint snapshot::read_last_checkpoint(std::string const &location, WordStore const &words,
+                                          grid::gidx max_height, grid::gidx max_width)
+{
+    MappedFile const file(location);
+    if (!file.is_open())
+        throw std::runtime_error("Could not read pool file " + location);
+    Reader const reader(file.data(), file.size(), location);
+
+    std::size_t offset = 0;
+    FileHeader const header = reader.read<FileHeader>(offset);
+    if (std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) != 0 || header.version != VERSION)
+        reader.fail("not a pool file of this version");
+    if (header.word_store_hash != hash_word_store(words))
+        reader.fail("it was written for another word list");
+    if (header.max_height != max_height || header.max_width != max_width)
+        reader.fail("it was written for other grid dimensions");
+
+    // a record cut off at the end of the file was being written when the run was killed
+    std::vector<GridSnapshot> grids;
+    Checkpoint last = { 0, -1, {}, {} };
+    while (reader.has(offset, sizeof(RecordHeader)))
+    {
+        RecordHeader const record = reader.read<RecordHeader>(offset);
+        if (!reader.has(offset, record.size))
+            break;
+        std::size_t const end = offset + record.size;
+
+        switch (record.type)
+        {
+        case GRID_RECORD:
+        {
+            GridRecord const grid = reader.read<GridRecord>(offset);
+            GridSnapshot snapshot = { static_cast<scoring::score>(grid.grid_score), grid.hash, grid.height,
+                                      grid.width, {} };
+            if (grid.height < 1 || grid.width < 1 || grid.height > max_height || grid.width > max_width
+                || !reader.has(offset, grid.word_count * sizeof(PlacedWordRecord)))
+                reader.fail("grid record is damaged");
+            for (std::uint32_t i = 0; i < grid.word_count; i++)
+            {
+                PlacedWordRecord const placed = reader.read<PlacedWordRecord>(offset);
+                if (placed.direction > grid::Direction::HORIZONTAL)
+                    reader.fail("grid record is damaged");
+                snapshot.words.push_back({ placed.word, { placed.row, placed.column,
+                                                          static_cast<grid::Direction>(placed.direction) } });
+                if (!fits(snapshot.words.back(), words, snapshot.height, snapshot.width))
+                    reader.fail("grid record refers to unknown words or locations");
+            }
+            grids.push_back(std::move(snapshot));
+            break;
+        }
+        case CHECKPOINT_RECORD:
+        {
+            CheckpointRecord const checkpoint = reader.read<CheckpointRecord>(offset);
+            if (checkpoint.grid_count != grids.size())
+                reader.fail("checkpoint without its grids");
+            last = { static_cast<unsigned int>(checkpoint.rng_seed),
+                     static_cast<std::int_fast32_t>(checkpoint.finished_restarts), {}, std::move(grids) };
+            for (std::uint32_t i = 0; i < checkpoint.worker_count; i++)
+            {
+                std::uint32_t const length = reader.read<std::uint32_t>(offset);
+                last.rng_states.push_back(reader.read_string(offset, length));
+            }
+            grids.clear();
+            break;
+        }
+        default:
+            reader.fail("unknown record type");
+        }
+        if (offset > end)
+            reader.fail("record larger than its size");
+        offset = end;
+    }
+
+    if (last.finished_restarts < 0)
+        reader.fail("no complete checkpoint");
+    return last;
+}
@@ -0,0 +1,101 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "grid.h"
+#include "scorer.h"
+#include "word.h"
+
+namespace snapshot {
+
+/**
+    A grid reduced to what is needed to rebuild it: the placed words in
+    placement order, with locations relative to the grid's used bounds.
+ */
+typedef struct GridSnapshot
+{
+    scoring::score grid_score;
+    // see Grid::get_hash()
+    std::uint64_t hash;
+    grid::gidx height;
+    grid::gidx width;
+
+    typedef struct PlacedWord
+    {
+        wid word;
+        grid::Location loc;
+    } PlacedWord;
+    std::vector<PlacedWord> words;
+} GridSnapshot;
+
+/**
+    State of a generation run, from which it can be resumed.
+ */
+typedef struct Checkpoint
+{
+    unsigned int rng_seed;
+    std::int_fast32_t finished_restarts;
+    // state of every worker's random generator after its last finished restart
+    std::vector<std::string> rng_states;
+    // the best grids so far, best first
+    std::vector<GridSnapshot> pool;
+} Checkpoint;
+
+GridSnapshot capture(grid::Grid const &grid, scoring::score grid_score);
+
+/**
+    Places the words of the snapshot on the empty grid 'grid'. The grid must
+    have been created for the word store and dimensions the snapshot was taken with.
+    Throws std::runtime_error if the snapshot refers to unknown words, does not
+    fit the grid, or its words do not rebuild the grid it was taken of.
+ */
+void restore(GridSnapshot const &snapshot, grid::Grid &grid);
+
+/**
+    Hash of all words and clues of a word store. Pool files are only read
+    back for the word store they were written for, as they refer to word ids.
+ */
+std::uint64_t hash_word_store(WordStore const &words);
+
+/**
+    Writes checkpoints to a pool file. The file is a header followed by
+    records, each of which starts with its type and size and is padded to
+    8 bytes. All fields have fixed widths and native byte order, so the file
+    can be mmap-ed and read in place. A checkpoint is written as one grid
+    record per pool grid followed by a checkpoint record. Every checkpoint
+    replaces the file, so it only ever holds the latest one: it is written
+    to a temporary file next to it, which is then renamed over the pool
+    file, thus a run killed while writing leaves the previous checkpoint intact.
+ */
+class PoolWriter
+{
+private:
+    std::string m_location;
+    std::string m_header;
+
+public:
+    /**
+        Prepares writing to the pool file, which is left as it is until the
+        first checkpoint is written. Throws std::runtime_error if the file
+        cannot be written.
+     */
+    PoolWriter(std::string const &location, WordStore const &words,
+               grid::gidx max_height, grid::gidx max_width);
+
+    /**
+        Replaces the pool file by one holding only the given checkpoint.
+     */
+    void write(Checkpoint const &checkpoint);
+};
+
+/**
+    Reads the last complete checkpoint of a pool file by mapping it into
+    memory. Throws std::runtime_error if the file cannot be read, has no
+    complete checkpoint or was written for other words or grid dimensions.
+ */
+Checkpoint read_last_checkpoint(std::string const &location, WordStore const &words,
+                                grid::gidx max_height, grid::gidx max_width);
+
+} // namespace snapshot
@@ -0,0 +1,164 @@
+#include <algorithm>
+#include <iostream>
+#include <numeric>
+#include <sstream>
+
+#include "layoutscorer.h"
+#include "simplescorer.h"
+#include "subsetengine.h"
+
+// number of crossing slots looked at for a word crossing two placed words,
+// once a word crossing one is found
+#define SLOT_TRIES 16
+// number of words of a pattern that are tried before giving up on it
+#define CANDIDATE_TRIES 32
+// number of random first words tried before giving up on the grid
+#define FIRST_WORD_TRIES 100
+
+using namespace search;
+
+template<typename ScorerPolicy>
+SubsetEngine<ScorerPolicy>::SubsetEngine(INIReader const &config) :
+    m_word_count(std::max(config.GetInteger("generator", "target_word_count", 40), 1L))
+{
+    std::ostringstream os;
+
+    os << "Initialized subset engine with the following parameters" << std::endl;
+    os << "target_word_count = " << m_word_count << std::endl;
+
+    std::cout << os.str();
+}
+
+template<typename ScorerPolicy>
+bool SubsetEngine<ScorerPolicy>::picks_words() const
+{
+    return true;
+}
+
+template<typename ScorerPolicy>
+std::size_t SubsetEngine<ScorerPolicy>::get_word_count(WordStore const &words) const
+{
+    return std::min(m_word_count, words.size());
+}
+
+template<typename ScorerPolicy>
+std::optional<typename SubsetEngine<ScorerPolicy>::Placement> SubsetEngine<ScorerPolicy>::find_placement(
+    grid::Grid const &grid, grid::CrossingSlot const &slot, std::int_fast16_t position,
+    std::int_fast16_t min_length, std::int_fast16_t max_length,
+    std::vector<PatternIndex::LetterAt> const &letters, std::vector<wid> const &placed,
+    Context<ScorerPolicy> &context, std::vector<wid> &buffer) const
+{
+    buffer.clear();
+    context.patterns.find(std::max<std::int_fast16_t>(min_length, 2), max_length, letters, buffer);
+    if (buffer.empty())
+        return std::nullopt;
+
+    grid::Location const loc = slot.direction == grid::Direction::VERTICAL
+                               ? grid::Location{ slot.row - position, slot.column, slot.direction }
+                               : grid::Location{ slot.row, slot.column - position, slot.direction };
+    // the matches are sorted by length, so start at a random one
+    std::size_t const start = std::uniform_int_distribution<std::size_t>(0, buffer.size() - 1)(context.rng);
+    for (std::size_t i = 0; i < std::min<std::size_t>(buffer.size(), CANDIDATE_TRIES); i++)
+    {
+        wid const word = buffer[(start + i) % buffer.size()];
+        if (std::find(placed.begin(), placed.end(), word) == placed.end() && grid.is_valid_placement(word, loc))
+            return Placement{ word, loc };
+    }
+    return std::nullopt;
+}
+
+template<typename ScorerPolicy>
+void SubsetEngine<ScorerPolicy>::fill_grid(grid::Grid &grid, WordStore const &words,
+                                           Context<ScorerPolicy> &context) const
+{
+    if (words.empty())
+        return;
+
+    std::size_t const word_count = get_word_count(words);
+    std::vector<wid> placed;
+    std::uniform_int_distribution<wid> word_dist(0, words.size() - 1);
+    std::uniform_int_distribution<int> dist(0, 1); // for generating random vert/horizontal
+    for (int i = 0; i < FIRST_WORD_TRIES && placed.empty(); i++)
+    {
+        wid const word = word_dist(context.rng);
+        if (words.length(word) >= 2 && grid.place_first_word(word, static_cast<grid::Direction>(dist(context.rng))))
+            placed.push_back(word);
+    }
+
+    std::vector<grid::CrossingSlot> slots;
+    std::vector<wid> buffer;
+    std::vector<PatternIndex::LetterAt> letters;
+    std::vector<std::int_fast16_t> positions;
+    auto shuffled_positions = [&](std::int_fast16_t first,
+                                  std::int_fast16_t last) -> std::vector<std::int_fast16_t> const & {
+        positions.resize(std::max<std::int_fast16_t>(last - first + 1, 0));
+        std::iota(positions.begin(), positions.end(), first);
+        std::shuffle(positions.begin(), positions.end(), context.rng);
+        return positions;
+    };
+
+    while (!placed.empty() && placed.size() < word_count && std::chrono::steady_clock::now() < context.deadline)
+    {
+        slots.clear();
+        grid.get_crossing_slots(slots);
+        std::shuffle(slots.begin(), slots.end(), context.rng);
+
+        std::optional<Placement> single, dual;
+        std::size_t tries = 0;
+        for (auto const &slot : slots)
+        {
+            // Longest part of a word before/after the slot's cell that stays
+            // within the free run. Its end may not touch a stop letter.
+            std::int_fast16_t const before = slot.reach_before - (slot.stop_before != grid::Grid::EMPTY_CHAR);
+            std::int_fast16_t const after = slot.reach_after - (slot.stop_after != grid::Grid::EMPTY_CHAR);
+
+            // a word running through a stop letter crosses two words
+            if (slot.stop_before != grid::Grid::EMPTY_CHAR && after >= 0)
+            {
+                for (auto const position : shuffled_positions(slot.reach_before + 1, words.max_length() - 1))
+                {
+                    letters = { { static_cast<std::uint16_t>(position), slot.letter },
+                                { static_cast<std::uint16_t>(position - slot.reach_before - 1), slot.stop_before } };
+                    if ((dual = find_placement(grid, slot, position, position + 1, position + after + 1, letters,
+                                               placed, context, buffer)))
+                        break;
+                }
+            }
+            if (!dual && slot.stop_after != grid::Grid::EMPTY_CHAR && before >= 0)
+            {
+                for (auto const position : shuffled_positions(0, before))
+                {
+                    letters = { { static_cast<std::uint16_t>(position), slot.letter },
+                                { static_cast<std::uint16_t>(position + slot.reach_after + 1), slot.stop_after } };
+                    if ((dual = find_placement(grid, slot, position, position + slot.reach_after + 2,
+                                               words.max_length(), letters, placed, context, buffer)))
+                        break;
+                }
+            }
+            if (dual)
+                break;
+
+            if (!single && after >= 0)
+            {
+                for (auto const position : shuffled_positions(0, before))
+                {
+                    letters = { { static_cast<std::uint16_t>(position), slot.letter } };
+                    if ((single = find_placement(grid, slot, position, position + 1, position + after + 1, letters,
+                                                 placed, context, buffer)))
+                        break;
+                }
+            }
+            if (single && ++tries >= SLOT_TRIES)
+                break;
+        }
+
+        std::optional<Placement> const &placement = dual ? dual : single;
+        if (!placement)
+            break;
+        grid.place_word_unchecked(placement->word, placement->loc);
+        placed.push_back(placement->word);
+    }
+}
+
+template class search::SubsetEngine<scoring::SimpleScorerPolicy>;
+template class search::SubsetEngine<scoring::LayoutScorerPolicy>;
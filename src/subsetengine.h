@@ -0,0 +1,54 @@
+#pragma once
+
+#include <cstddef>
+#include <optional>
+#include <vector>
+
+#include "engine.h"
+
+#include "INIReader.h"
+
+namespace search {
+
+/**
+    Builds grids of target_word_count words picked from a word list that is
+    much larger, like a themed dictionary. After a random first word, every
+    step looks at the letters a new word can still cross (see
+    Grid::get_crossing_slots()) and looks up words fitting there in the
+    pattern index, instead of trying every word of the list. Words crossing
+    two placed words at once are preferred, which keeps the grids dense.
+ */
+template<typename ScorerPolicy>
+class SubsetEngine : public BasicEngine<ScorerPolicy>
+{
+private:
+    typedef struct Placement
+    {
+        wid word;
+        grid::Location loc;
+    } Placement;
+
+    std::size_t m_word_count;
+
+    /**
+        Looks up the words of a length in [min_length, max_length] with the
+        given letters, and returns a valid placement of one of them that is
+        not placed yet. Offset 'position' of the word is put on the slot's cell.
+     */
+    std::optional<Placement> find_placement(grid::Grid const &grid, grid::CrossingSlot const &slot,
+                                            std::int_fast16_t position, std::int_fast16_t min_length,
+                                            std::int_fast16_t max_length,
+                                            std::vector<PatternIndex::LetterAt> const &letters,
+                                            std::vector<wid> const &placed, Context<ScorerPolicy> &context,
+                                            std::vector<wid> &buffer) const;
+
+public:
+    SubsetEngine(INIReader const &config);
+
+    bool picks_words() const override;
+    std::size_t get_word_count(WordStore const &words) const override;
+
+    void fill_grid(grid::Grid &grid, WordStore const &words, Context<ScorerPolicy> &context) const override;
+};
+
+} // namespace search
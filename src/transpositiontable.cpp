@@ -0,0 +1,70 @@
+#include <algorithm>
+
+#include "transpositiontable.h"
+
+using namespace search;
+
+TranspositionTable::TranspositionTable(std::size_t size) :
+    m_bucket_mask(0), m_enabled(size > 0), m_used(true)
+{
+    std::size_t bucket_count = 1;
+    while (bucket_count * BUCKET_SIZE < size)
+    {
+        bucket_count *= 2;
+    }
+    m_buckets = std::make_unique<Bucket[]>(bucket_count);
+    m_bucket_mask = bucket_count - 1;
+    clear();
+}
+
+TranspositionTable::Bucket & TranspositionTable::bucket(std::uint64_t hash) const
+{
+    // the low bits of a grid hash are the weakest, so take the high ones
+    return m_buckets[(hash >> 32) & m_bucket_mask];
+}
+
+// the empty grid hashes to 0, which marks an empty entry
+static inline std::uint64_t stored_hash(std::uint64_t hash)
+{
+    return hash == 0 ? 1 : hash;
+}
+
+scoring::score const * TranspositionTable::find(std::uint64_t hash) const
+{
+    if (!m_enabled)
+        return nullptr;
+
+    hash = stored_hash(hash);
+    for (Entry const &entry : bucket(hash))
+    {
+        if (entry.hash == hash)
+            return &entry.grid_score;
+    }
+    return nullptr;
+}
+
+bool TranspositionTable::insert(std::uint64_t hash, scoring::score grid_score)
+{
+    if (!m_enabled)
+        return true;
+
+    hash = stored_hash(hash);
+    Bucket &entries = bucket(hash);
+    if (std::any_of(entries.begin(), entries.end(), [hash](Entry const &entry) { return entry.hash == hash; }))
+        return false;
+
+    m_used = true;
+    // drop the oldest hash of the bucket
+    std::move_backward(entries.begin(), entries.end() - 1, entries.end());
+    entries.front() = { hash, grid_score };
+    return true;
+}
+
+void TranspositionTable::clear()
+{
+    if (!m_used)
+        return;
+
+    std::fill(m_buckets.get(), m_buckets.get() + m_bucket_mask + 1, Bucket{});
+    m_used = false;
+}
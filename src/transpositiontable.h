@@ -0,0 +1,65 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <memory>
+
+#include "scorer.h"
+
+namespace search {
+
+/**
+    Bounded set of grid hashes (see Grid::get_hash()) with a score per hash,
+    used to recognize grids that were built before. The table never grows:
+    when a bucket is full, its oldest hash is dropped, so a grid may be seen
+    as new again after many others. A table of size 0 records nothing.
+    Not thread-safe, every worker has its own tables.
+ */
+class TranspositionTable
+{
+private:
+    static constexpr std::size_t BUCKET_SIZE = 4;
+
+    typedef struct Entry
+    {
+        // 0 marks an empty entry
+        std::uint64_t hash;
+        scoring::score grid_score;
+    } Entry;
+
+    // hashes of a bucket, the most recent first
+    typedef std::array<Entry, BUCKET_SIZE> Bucket;
+
+    std::unique_ptr<Bucket[]> m_buckets;
+    std::uint64_t m_bucket_mask;
+    bool m_enabled;
+    // false while the table is empty, so clearing an unused table is free
+    bool m_used;
+
+    Bucket & bucket(std::uint64_t hash) const;
+
+public:
+    /**
+        @param size maximum number of hashes recorded, rounded up to a power of two
+     */
+    TranspositionTable(std::size_t size);
+
+    /**
+        @return the score recorded with the hash, or nullptr if it is not in the table
+     */
+    scoring::score const * find(std::uint64_t hash) const;
+
+    /**
+        Records a hash. A hash already in the table keeps its score.
+        @return true if the hash was not in the table before
+     */
+    bool insert(std::uint64_t hash, scoring::score grid_score = 0);
+
+    /**
+        Removes all hashes, keeping the allocated memory. Free if nothing was
+        inserted since the last call.
+     */
+    void clear();
+};
+
+} // namespace search
@@ -0,0 +1,106 @@
+#include <stdexcept>
+
+#include "word.h"
+
+WordStore::WordStore()
+{
+    refresh_tables();
+}
+
+void WordStore::refresh_tables()
+{
+    m_tables.letters = m_letters.data();
+    m_tables.clues = m_clues.data();
+    m_tables.letter_offsets = m_letter_offsets.data();
+    m_tables.lengths = m_lengths.data();
+    m_tables.clue_offsets = m_clue_offsets.data();
+    m_tables.size = m_lengths.size();
+
+    // the letter counts are never empty once built
+    bool const has_length_tables = !m_letter_counts.empty();
+    m_tables.length_offsets = has_length_tables ? m_length_offsets.data() : nullptr;
+    m_tables.by_length = has_length_tables ? m_by_length.data() : nullptr;
+    m_tables.letter_counts = has_length_tables ? m_letter_counts.data() : nullptr;
+}
+
+void WordStore::reserve(std::size_t count, std::size_t letter_count, std::size_t clue_count)
+{
+    m_letters.reserve(m_letters.size() + letter_count);
+    m_clues.reserve(m_clues.size() + clue_count);
+    m_letter_offsets.reserve(m_letter_offsets.size() + count);
+    m_lengths.reserve(m_lengths.size() + count);
+    m_clue_offsets.reserve(m_clue_offsets.size() + count);
+}
+
+wid WordStore::add(std::string_view clue, std::string_view word)
+{
+    if (m_external != nullptr)
+        throw std::runtime_error("Cannot add words to a compiled word list");
+
+    std::size_t const offset = m_letters.size() - LETTER_PADDING;
+    m_letter_offsets.push_back(offset);
+    m_lengths.push_back(word.length());
+    m_tables.max_length = std::max<std::int_fast16_t>(m_tables.max_length, word.length());
+    m_letters.insert(offset, word);
+    m_clues.append(clue);
+    m_clue_offsets.push_back(m_clues.size());
+
+    // the length tables no longer cover all words
+    m_length_offsets.clear();
+    m_by_length.clear();
+    m_letter_counts.clear();
+    refresh_tables();
+    return m_lengths.size() - 1;
+}
+
+void WordStore::build_length_tables()
+{
+    if (m_external != nullptr)
+        return;
+
+    // counting sort of the word ids by length, which keeps words of the same length in order
+    m_length_offsets.assign(m_tables.max_length + 2, 0);
+    for (auto const length : m_lengths)
+    {
+        m_length_offsets[length + 1]++;
+    }
+    for (std::size_t l = 1; l < m_length_offsets.size(); l++)
+    {
+        m_length_offsets[l] += m_length_offsets[l - 1];
+    }
+    m_by_length.resize(m_lengths.size());
+    std::vector<std::uint32_t> next(m_length_offsets.begin(), m_length_offsets.end() - 1);
+    for (wid id = 0; id < m_lengths.size(); id++)
+    {
+        m_by_length[next[m_lengths[id]]++] = id;
+    }
+
+    m_letter_counts.assign(LETTER_COUNT_SIZE, 0);
+    for (char const letter : std::string_view(m_letters).substr(0, m_letters.size() - LETTER_PADDING))
+    {
+        m_letter_counts[static_cast<unsigned char>(letter)]++;
+    }
+    refresh_tables();
+}
+
+void WordStore::attach(Tables const &tables, std::shared_ptr<void const> memory)
+{
+    if (!empty())
+        throw std::runtime_error("Cannot attach a compiled word list to a non-empty word store");
+
+    m_letters.clear();
+    m_letters.shrink_to_fit();
+    m_clue_offsets.clear();
+    m_tables = tables;
+    m_external = std::move(memory);
+}
+
+WordRange WordStore::words_of_length(std::int_fast16_t min_length, std::int_fast16_t max_length) const
+{
+    min_length = std::max<std::int_fast16_t>(min_length, 0);
+    max_length = std::min(max_length, m_tables.max_length);
+    if (min_length > max_length)
+        return { m_tables.by_length, m_tables.by_length };
+    return { m_tables.by_length + m_tables.length_offsets[min_length],
+             m_tables.by_length + m_tables.length_offsets[max_length + 1] };
+}
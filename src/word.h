@@ -1,29 +1,219 @@
 #pragma once
 
+#include <algorithm>
 #include <cstdint>
+#include <memory>
 #include <vector>
 #include <string>
+#include <string_view>
 
-typedef std::uint_fast16_t wid;
+#include "alphabet.h"
 
+typedef std::uint32_t wid;
+
+/**
+    View of a single word of a WordStore. Cheap to copy, as the clue and the
+    letters are owned by the store.
+ */
 typedef struct Word
 {
     wid id;
 
-    std::string clue;
-    std::string word;
+    std::string_view clue;
+    // letters as codes of the word store's alphabet
+    std::string_view word;
 
     std::int_fast16_t length;
 
-    Word(wid id_, std::string const &clue_, std::string const &word_) :
-        id(id_), clue(clue_), word(word_), length(word_.length())
-    {
-    }
-
     char const& operator[](int index) const
     {
         return word[index];
     }
 } Word;
 
-typedef std::vector<Word> WordList;
+/**
+    Ids of consecutive words of a WordStore's tables.
+ */
+typedef struct WordRange
+{
+    wid const *first;
+    wid const *last;
+
+    wid const * begin() const { return first; }
+    wid const * end() const { return last; }
+    std::size_t size() const { return last - first; }
+    bool empty() const { return first == last; }
+} WordRange;
+
+/**
+    Immutable (once filled by a WordProvider) store of all words. Words are
+    interned in a structure-of-arrays layout: the letters of all words are
+    kept back to back in one buffer, the clues in another, and words are
+    referred to by their index (wid) into the offset and length arrays.
+    Letters are stored as codes of the store's alphabet, clues as UTF-8.
+    The arrays are either owned by the store, or kept in external memory
+    such as a mapped compiled word list (see attach()).
+ */
+class WordStore
+{
+public:
+    /**
+        The letters of a word can be read this many bytes past their end,
+        which lets vectorized code process words in whole registers.
+     */
+    static constexpr std::size_t LETTER_PADDING = 32;
+
+    /**
+        The arrays of a store, all accessors read through these.
+     */
+    typedef struct Tables
+    {
+        std::size_t size;
+        std::int_fast16_t max_length;
+        // all letters (alphabet codes), followed by LETTER_PADDING zero bytes
+        char const *letters;
+        char const *clues;
+        // word i spans [letter_offsets[i], letter_offsets[i] + lengths[i]) of letters
+        std::uint32_t const *letter_offsets;
+        std::uint16_t const *lengths;
+        // clue i spans [clue_offsets[i], clue_offsets[i + 1]) of clues
+        std::uint32_t const *clue_offsets;
+
+        // Length tables, nullptr until built. The words of length l are
+        // [length_offsets[l], length_offsets[l + 1]) of by_length.
+        std::uint32_t const *length_offsets;
+        wid const *by_length;
+        // number of occurrences of every alphabet code in all words
+        std::uint32_t const *letter_counts;
+    } Tables;
+
+    static constexpr std::size_t LETTER_COUNT_SIZE = Alphabet::MAX_SIZE;
+
+private:
+    // owned arrays, empty if the store is attached to external memory
+    std::string m_letters = std::string(LETTER_PADDING, '\0');
+    std::string m_clues;
+    std::vector<std::uint32_t> m_letter_offsets;
+    std::vector<std::uint16_t> m_lengths;
+    std::vector<std::uint32_t> m_clue_offsets = { 0 };
+    std::vector<std::uint32_t> m_length_offsets;
+    std::vector<wid> m_by_length;
+    std::vector<std::uint32_t> m_letter_counts;
+
+    Alphabet m_alphabet;
+    Tables m_tables = {};
+    // keeps the external memory the tables point to alive
+    std::shared_ptr<void const> m_external;
+
+    void refresh_tables();
+
+public:
+    WordStore();
+
+    // the tables point into the store itself
+    WordStore(WordStore const &) = delete;
+    WordStore & operator=(WordStore const &) = delete;
+
+    /**
+        Reserves space for 'count' more words with the given total number of
+        letters and clue characters.
+     */
+    void reserve(std::size_t count, std::size_t letter_count, std::size_t clue_count);
+
+    /**
+        Sets the alphabet the letters of the words are encoded with.
+     */
+    void set_alphabet(Alphabet alphabet)
+    {
+        m_alphabet = std::move(alphabet);
+    }
+
+    Alphabet const & alphabet() const
+    {
+        return m_alphabet;
+    }
+
+    /**
+        Appends a word, whose letters are codes of the alphabet. Throws std::runtime_error if the store
+        is attached to external memory.
+        @return the id of the new word
+     */
+    wid add(std::string_view clue, std::string_view word);
+
+    /**
+        Builds the length buckets and letter counts of all words. Providers
+        call this once they have added all words.
+     */
+    void build_length_tables();
+
+    /**
+        Makes the (empty) store use the given tables, which must include the
+        length tables. 'memory' owns what the tables point to. Throws
+        std::runtime_error if the store is not empty.
+     */
+    void attach(Tables const &tables, std::shared_ptr<void const> memory);
+
+    Tables const & tables() const
+    {
+        return m_tables;
+    }
+
+    std::size_t size() const
+    {
+        return m_tables.size;
+    }
+
+    bool empty() const
+    {
+        return m_tables.size == 0;
+    }
+
+    std::int_fast16_t length(wid id) const
+    {
+        return m_tables.lengths[id];
+    }
+
+    /**
+        Length of the longest word in the store.
+     */
+    std::int_fast16_t max_length() const
+    {
+        return m_tables.max_length;
+    }
+
+    std::string_view letters(wid id) const
+    {
+        return std::string_view(m_tables.letters + m_tables.letter_offsets[id], m_tables.lengths[id]);
+    }
+
+    std::string_view clue(wid id) const
+    {
+        return std::string_view(m_tables.clues + m_tables.clue_offsets[id],
+                                m_tables.clue_offsets[id + 1] - m_tables.clue_offsets[id]);
+    }
+
+    Word operator[](wid id) const
+    {
+        return { id, clue(id), letters(id), length(id) };
+    }
+
+    bool has_length_tables() const
+    {
+        return m_tables.by_length != nullptr;
+    }
+
+    /**
+        Words with a length in [min_length, max_length], shortest first. The
+        length tables must have been built.
+     */
+    WordRange words_of_length(std::int_fast16_t min_length, std::int_fast16_t max_length) const;
+
+    /**
+        Number of occurrences of a letter (alphabet code) in all words. The length tables
+        must have been built.
+     */
+    std::uint32_t letter_count(char letter) const
+    {
+        return m_tables.letter_counts[static_cast<unsigned char>(letter)];
+    }
+};
@@ -1,18 +1,23 @@
 #include <utility>
 
+#include "compiledwordprovider.h"
 #include "csvwordprovider.h"
 
 using namespace std;
 
-map<string, function<unique_ptr<WordProvider>(string)> > WordProvider::m_factories =
+map<string, function<unique_ptr<WordProvider>(string, string, bool)> > WordProvider::m_factories =
 {
-    { "csv", [](const string& location){
+    { "csv", [](const string& location, const string&, bool){
           return make_unique<CSVWordProvider>(location);
       }
+    },
+    { "compiled", [](const string& location, const string& source_location, bool verify){
+          return make_unique<CompiledWordProvider>(location, source_location, verify);
+      }
     }
 };
 
-string WordProvider::trim(string const &str)
+string_view WordProvider::trim(string_view str)
 {
     size_t first = str.find_first_not_of(' ');
     if (string::npos == first)
@@ -23,11 +28,12 @@ string WordProvider::trim(string const &str)
     return str.substr(first, (last - first + 1));
 }
 
-unique_ptr<WordProvider> WordProvider::create(const string& type, const string& location)
+unique_ptr<WordProvider> WordProvider::create(const string& type, const string& location,
+                                              const string& source_location, bool verify)
 {
     if(m_factories.count(type) > 0)
     {
-        return m_factories[type](location);
+        return m_factories[type](location, source_location, verify);
     }
     else
     {
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <string>
+#include <string_view>
 #include <memory>
 #include <map>
 #include <functional>
@@ -10,25 +11,31 @@
 class WordProvider
 {
 private:
-    static std::map<std::string, std::function<std::unique_ptr<WordProvider>(std::string) > > m_factories;
+    static std::map<std::string, std::function<std::unique_ptr<WordProvider>(std::string, std::string, bool) > > m_factories;
 
 public:
     /**
         Convenience function to trim leader/trailing whitespaces
      */
-    static std::string trim(std::string const &str);
+    static std::string_view trim(std::string_view str);
 
     /**
-       Retrieves a list of crossword words from an abstract source.
-       @param wordlist The word list to which the retrieved words are appended
+       Retrieves a list of crossword words from an abstract source and
+       builds the length tables of the word store.
+       @param words The word store to which the retrieved words are appended
        to.
      */
-    virtual void retrieve_word_list(WordList& wordlist) const = 0;
+    virtual void retrieve_word_list(WordStore& words) const = 0;
 
     /**
        Creates and returns a WordProvider of type type.
        @param type Provider type to create
        @param location Path were the file is located
+       @param source_location Path of the CSV file a compiled word list was
+       compiled from, or an empty string. Ignored by the other provider types.
+       @param verify Whether a compiled word list is verified word by word
+       when loading. Ignored by the other provider types.
      */
-    static std::unique_ptr<WordProvider> create(const std::string& type, const std::string& location);
+    static std::unique_ptr<WordProvider> create(const std::string& type, const std::string& location,
+                                                const std::string& source_location = "", bool verify = false);
 };
\ No newline at end of file
@@ -0,0 +1,27 @@
+#pragma once
+
+#include <iostream>
+#include <string>
+
+/**
+    Number of failed checks of the test. A test runs on after a failed
+    check and exits with 1 at the end if any check failed.
+ */
+inline int failures = 0;
+
+/**
+    Reports a failed check on std::cerr and counts it.
+    @param what The property that was checked.
+    @param context Where it was checked, e.g. the step of a random test,
+    or an empty string.
+ */
+inline void check(bool condition, std::string const &what, std::string const &context = "")
+{
+    if (condition)
+        return;
+    std::cerr << "FAIL: " << what;
+    if (!context.empty())
+        std::cerr << " (" << context << ")";
+    std::cerr << std::endl;
+    failures++;
+}
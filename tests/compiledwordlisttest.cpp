@@ -0,0 +1,210 @@
+/**
+    Test of the compiled word list format: a compiled word list must hold the
+    same words as the CSV file it was compiled from, and a damaged one, or
+    when verifying an out of date one, must be rejected before the word store
+    is attached to it, or be replaced by the CSV file if the provider knows
+    it. Every failed check is reported, and the test exits with 1 at the end
+    if any check failed.
+ */
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "check.h"
+#include "compiledwordprovider.h"
+#include "csvwordprovider.h"
+
+namespace
+{
+
+// positions in the file header, see compiledwordprovider.cpp
+constexpr std::size_t WORD_COUNT_POSITION = 24;
+constexpr std::size_t SECTIONS_POSITION = 40;
+enum Section { LETTERS = 0, LETTER_OFFSETS = 2, LENGTHS = 3, BY_LENGTH = 6 };
+
+std::filesystem::path temp_file(std::string const &name)
+{
+    return std::filesystem::temp_directory_path() / name;
+}
+
+void write_word_list(std::filesystem::path const &location, int count)
+{
+    std::ofstream out(location);
+    out << "Clue,Solution" << std::endl;
+    for (int i = 0; i < count; i++)
+    {
+        out << "Clue " << i << "," << std::string(2 + i % 7, "ABCDE"[i % 5]) << std::endl;
+    }
+}
+
+std::vector<char> read_file(std::filesystem::path const &location)
+{
+    std::ifstream in(location, std::ios::binary);
+    return std::vector<char>(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+}
+
+void write_file(std::filesystem::path const &location, std::vector<char> const &contents)
+{
+    std::ofstream out(location, std::ios::binary | std::ios::trunc);
+    out.write(contents.data(), contents.size());
+}
+
+std::uint64_t section_offset(std::vector<char> const &file, int section)
+{
+    std::uint64_t offset;
+    std::memcpy(&offset, file.data() + SECTIONS_POSITION + 16 * section, sizeof(offset));
+    return offset;
+}
+
+template <typename T>
+void poke(std::vector<char> &file, std::uint64_t position, T value)
+{
+    std::memcpy(file.data() + position, &value, sizeof(value));
+}
+
+bool same_words(WordStore const &a, WordStore const &b)
+{
+    if (a.size() != b.size())
+        return false;
+    for (wid id = 0; id < a.size(); id++)
+    {
+        if (a.letters(id) != b.letters(id) || a.clue(id) != b.clue(id))
+            return false;
+    }
+    return true;
+}
+
+/**
+    Loads a damaged compiled word list, once without and once with the CSV
+    file, and checks that it is rejected, or replaced by the CSV file.
+    Damaged words are only noticed when verifying.
+ */
+void check_rejected(std::vector<char> const &contents, std::string const &csv, WordStore const &expected,
+                    bool verify, std::string const &context)
+{
+    std::filesystem::path const location = temp_file("compiledwordlisttest_damaged.cwl");
+    write_file(location, contents);
+
+    WordStore words;
+    bool rejected = false;
+    try
+    {
+        CompiledWordProvider(location.string(), "", verify).retrieve_word_list(words);
+    }
+    catch (std::runtime_error const &)
+    {
+        rejected = true;
+    }
+    check(rejected, "damaged word list rejected", context);
+    check(words.empty(), "word store untouched", context);
+
+    WordStore fallback;
+    CompiledWordProvider(location.string(), csv, verify).retrieve_word_list(fallback);
+    check(same_words(fallback, expected), "words read from the CSV file", context);
+}
+
+} // namespace
+
+int main()
+{
+    std::filesystem::path const csv = temp_file("compiledwordlisttest_words.csv");
+    std::filesystem::path const compiled = temp_file("compiledwordlisttest_words.cwl");
+    write_word_list(csv, 40);
+    CompiledWordProvider::compile(csv.string(), compiled.string());
+
+    WordStore expected;
+    CSVWordProvider(csv.string()).retrieve_word_list(expected);
+    for (bool verify : { false, true })
+    {
+        WordStore words;
+        CompiledWordProvider(compiled.string(), csv.string(), verify).retrieve_word_list(words);
+        check(same_words(words, expected), "compiled words", "intact");
+        check(words.max_length() == expected.max_length(), "compiled max length", "intact");
+    }
+
+    std::vector<char> const file = read_file(compiled);
+    std::uint64_t const letters = section_offset(file, LETTERS);
+    std::uint64_t const letter_offsets = section_offset(file, LETTER_OFFSETS);
+    std::uint64_t const lengths = section_offset(file, LENGTHS);
+    std::uint64_t const by_length = section_offset(file, BY_LENGTH);
+
+    check_rejected(std::vector<char>(file.begin(), file.begin() + file.size() / 2), csv.string(), expected,
+                   false, "truncated");
+    std::vector<char> damaged = file;
+    poke<std::uint64_t>(damaged, WORD_COUNT_POSITION, 41);
+    check_rejected(damaged, csv.string(), expected, false, "word count");
+    damaged = file;
+    poke<std::uint32_t>(damaged, letter_offsets + 39 * sizeof(std::uint32_t), 1u << 30);
+    check_rejected(damaged, csv.string(), expected, true, "letter offset");
+    damaged = file;
+    poke<std::uint16_t>(damaged, lengths + 5 * sizeof(std::uint16_t), 9);
+    check_rejected(damaged, csv.string(), expected, true, "length");
+    damaged = file;
+    poke<wid>(damaged, by_length, 1000);
+    check_rejected(damaged, csv.string(), expected, true, "length table");
+    damaged = file;
+    damaged[letters] = 60;
+    check_rejected(damaged, csv.string(), expected, true, "letter code");
+    // letters shorter than the first word, followed by their padding, and
+    // the first word's letters far beyond them
+    damaged = file;
+    damaged.resize((damaged.size() + 7) / 8 * 8, 0);
+    poke<std::uint64_t>(damaged, SECTIONS_POSITION + 16 * LETTERS, damaged.size());
+    poke<std::uint64_t>(damaged, SECTIONS_POSITION + 16 * LETTERS + 8, WordStore::LETTER_PADDING + 1);
+    damaged.push_back('A');
+    damaged.resize(damaged.size() + WordStore::LETTER_PADDING, 0);
+    poke<std::uint32_t>(damaged, letter_offsets, 0x7FFFFFF0);
+    check_rejected(damaged, csv.string(), expected, true, "short letters");
+
+    // a random byte changed anywhere must never make a verifying provider
+    // read past the file; the word list is either rejected or attached
+    std::default_random_engine rng(1);
+    for (int i = 0; i < 500; i++)
+    {
+        damaged = file;
+        damaged[std::uniform_int_distribution<std::size_t>(0, file.size() - 1)(rng)] ^=
+            static_cast<char>(std::uniform_int_distribution<int>(1, 255)(rng));
+        write_file(compiled, damaged);
+        WordStore words;
+        try
+        {
+            CompiledWordProvider(compiled.string(), "", true).retrieve_word_list(words);
+        }
+        catch (std::runtime_error const &)
+        {
+            continue;
+        }
+        for (wid id = 0; id < words.size(); id++)
+        {
+            check(words.letters(id).size() == static_cast<std::size_t>(words.length(id)), "word readable",
+                  "random damage");
+        }
+    }
+
+    // the CSV file changed after compiling
+    write_file(compiled, file);
+    write_word_list(csv, 41);
+    WordStore changed;
+    CSVWordProvider(csv.string()).retrieve_word_list(changed);
+    WordStore words;
+    CompiledWordProvider(compiled.string(), csv.string(), true).retrieve_word_list(words);
+    check(same_words(words, changed), "out of date word list replaced by the CSV file", "checksum");
+    WordStore unverified;
+    CompiledWordProvider(compiled.string(), csv.string()).retrieve_word_list(unverified);
+    check(same_words(unverified, expected), "out of date word list attached without verifying", "checksum");
+
+    if (failures > 0)
+    {
+        std::cerr << failures << " compiled word list checks failed" << std::endl;
+        return 1;
+    }
+    std::cout << "Compiled word lists checked" << std::endl;
+    return 0;
+}
@@ -0,0 +1,119 @@
+/**
+    Test of CrossingIndex against a brute force comparison of the letters of
+    every pair of words. Every mismatch is reported, and the test exits
+    with 1 at the end if any check failed.
+ */
+#include <algorithm>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include "check.h"
+#include "crossingindex.h"
+#include "csvwordprovider.h"
+
+namespace
+{
+
+typedef std::tuple<wid, std::uint16_t, std::uint16_t> Key;
+
+// random words over a small alphabet, the same word twice, and words without
+// any letter another word has
+std::string write_word_list(std::default_random_engine &rng)
+{
+    std::filesystem::path const location = std::filesystem::temp_directory_path() / "crossingindextest_words.csv";
+    std::ofstream out(location);
+    out << "Clue,Solution" << std::endl;
+    for (int i = 0; i < 80; i++)
+    {
+        std::string word;
+        for (int length = std::uniform_int_distribution<int>(2, 9)(rng); length > 0; length--)
+        {
+            word += "ABCDEFG"[std::uniform_int_distribution<int>(0, 6)(rng)];
+        }
+        out << "Clue " << i << "," << word << std::endl;
+    }
+    out << "Twice 1,ABBA" << std::endl << "Twice 2,ABBA" << std::endl;
+    out << "Alone 1,XX" << std::endl << "Alone 2,QZQ" << std::endl;
+    return location.string();
+}
+
+} // namespace
+
+int main()
+{
+    std::default_random_engine rng(1);
+    WordStore words;
+    CSVWordProvider(write_word_list(rng)).retrieve_word_list(words);
+    CrossingIndex const index(words);
+
+    std::size_t total = 0;
+    std::size_t uncrossable = 0;
+    for (wid word = 0; word < words.size(); word++)
+    {
+        std::string const context = "word " + std::to_string(word);
+        std::string_view const letters = words.letters(word);
+        std::vector<Key> expected;
+        std::vector<wid> expected_words;
+        for (wid other = 0; other < words.size(); other++)
+        {
+            if (other == word)
+                continue;
+            std::string_view const other_letters = words.letters(other);
+            std::vector<Key> with_other;
+            for (std::uint16_t i = 0; i < letters.size(); i++)
+            {
+                for (std::uint16_t j = 0; j < other_letters.size(); j++)
+                {
+                    if (letters[i] == other_letters[j])
+                        with_other.push_back({ other, i, j });
+                }
+            }
+
+            std::vector<Key> found;
+            for (Crossing const &crossing : index.crossings(word, other))
+            {
+                found.push_back({ crossing.word, crossing.position, crossing.other_position });
+            }
+            std::sort(found.begin(), found.end());
+            check(found == with_other, "crossings with one word", context + ", other " + std::to_string(other));
+
+            expected.insert(expected.end(), with_other.begin(), with_other.end());
+            if (!with_other.empty())
+                expected_words.push_back(other);
+        }
+
+        std::vector<Key> found;
+        wid previous = 0;
+        for (Crossing const &crossing : index.crossings(word))
+        {
+            check(crossing.word >= previous, "crossings sorted by word", context);
+            previous = crossing.word;
+            found.push_back({ crossing.word, crossing.position, crossing.other_position });
+        }
+        std::sort(found.begin(), found.end());
+        check(found == expected, "crossings", context);
+
+        std::vector<wid> const crossing_words(index.crossing_words(word).begin(), index.crossing_words(word).end());
+        check(crossing_words == expected_words, "crossing words", context);
+        check(index.can_cross(word) == !expected.empty(), "can cross", context);
+
+        total += expected.size();
+        uncrossable += expected.empty();
+    }
+    check(index.size() == total, "size", "all words");
+    check(index.get_uncrossable_count() == uncrossable && uncrossable == 2, "uncrossable words", "all words");
+
+    if (failures > 0)
+    {
+        std::cerr << failures << " crossing index checks failed" << std::endl;
+        return 1;
+    }
+    std::cout << "Crossing index consistent with a brute force comparison" << std::endl;
+    return 0;
+}
@@ -0,0 +1,286 @@
+/**
+    Consistency test of grid::Grid against a reference model that only
+    knows the placed words and derives everything else cell by cell.
+    Random placements, undos, removals in any order and resets are applied
+    to grids of fixed and of runtime dimensions, and after every step the
+    counts, cells, hash, placement rules and layout metrics of the grid are
+    compared with the model's. The steps stop once a check failed, and the
+    test exits with 1 at the end if any check failed.
+ */
+#include <algorithm>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <random>
+#include <set>
+#include <sstream>
+#include <utility>
+#include <vector>
+
+#include "check.h"
+#include "csvwordprovider.h"
+#include "grid.h"
+#include "snapshot.h"
+
+using namespace grid;
+
+namespace
+{
+
+typedef std::pair<gidx, gidx> Cell;
+
+class Model
+{
+public:
+    WordStore const &words;
+    gidx max_rows, max_columns;
+    std::map<Location, wid> placed;
+
+    Model(WordStore const &words, gidx max_rows, gidx max_columns) :
+        words(words), max_rows(max_rows), max_columns(max_columns)
+    {
+    }
+
+    static Cell cell_of(Location const &loc, gidx i)
+    {
+        return loc.direction == Direction::HORIZONTAL ? Cell{ loc.row, loc.column + i }
+                                                      : Cell{ loc.row + i, loc.column };
+    }
+
+    // letter and number of covering words of every occupied cell
+    std::map<Cell, std::pair<char, int> > cells() const
+    {
+        std::map<Cell, std::pair<char, int> > result;
+        for (auto const &[loc, id] : placed)
+        {
+            for (gidx i = 0; i < words.length(id); i++)
+            {
+                auto &entry = result[cell_of(loc, i)];
+                entry.first = words.letters(id)[i];
+                entry.second++;
+            }
+        }
+        return result;
+    }
+
+    // used bounds as min row, max row, min column, max column
+    std::vector<gidx> bounds() const
+    {
+        std::vector<gidx> result = { 1 << 20, -1, 1 << 20, -1 };
+        for (auto const &[loc, id] : placed)
+        {
+            Cell const end = cell_of(loc, words.length(id) - 1);
+            result = { std::min(result[0], loc.row), std::max(result[1], end.first),
+                       std::min(result[2], loc.column), std::max(result[3], end.second) };
+        }
+        return result;
+    }
+
+    bool is_valid_placement(wid id, Location const &loc) const
+    {
+        auto const occupied = cells();
+        auto const at = [&occupied](Cell const &cell) { return occupied.count(cell) != 0; };
+        gidx const length = words.length(id);
+        Cell const first = cell_of(loc, 0), last = cell_of(loc, length - 1);
+        if (first.first < 0 || first.second < 0 || last.first >= 2 * max_rows || last.second >= 2 * max_columns)
+            return false;
+        std::vector<gidx> b = bounds();
+        if (std::max(b[1], last.first) - std::min(b[0], first.first) >= max_rows
+            || std::max(b[3], last.second) - std::min(b[2], first.second) >= max_columns)
+            return false;
+        if (at(cell_of(loc, -1)) || at(cell_of(loc, length)))
+            return false;
+
+        bool const horizontal = loc.direction == Direction::HORIZONTAL;
+        for (gidx i = 0; i < length; i++)
+        {
+            Cell const cell = cell_of(loc, i);
+            auto const it = occupied.find(cell);
+            if (it == occupied.end())
+            {
+                Cell const side1 = horizontal ? Cell{ cell.first - 1, cell.second } : Cell{ cell.first, cell.second - 1 };
+                Cell const side2 = horizontal ? Cell{ cell.first + 1, cell.second } : Cell{ cell.first, cell.second + 1 };
+                if (at(side1) || at(side2))
+                    return false;
+            }
+            else if (it->second.first != words.letters(id)[i] || (i + 1 < length && at(cell_of(loc, i + 1))))
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+};
+
+void compare(Grid &grid, Model const &model, std::default_random_engine &rng, std::string const &context)
+{
+    auto const cells = model.cells();
+    std::int_fast32_t letters = 0;
+    for (auto const &[loc, id] : model.placed)
+    {
+        letters += model.words.length(id);
+    }
+    check(grid.get_placed_word_count() == static_cast<std::int_fast32_t>(model.placed.size()), "word count", context);
+    check(grid.get_placed_letter_count() == static_cast<std::int_fast32_t>(cells.size()), "letter count", context);
+    check(grid.get_word_crossing_count() == letters - static_cast<std::int_fast32_t>(cells.size()),
+          "crossing count", context);
+    if (model.placed.empty())
+        return;
+
+    std::vector<gidx> const b = model.bounds();
+    check(grid.get_height() == b[1] - b[0] + 1 && grid.get_width() == b[3] - b[2] + 1, "used bounds", context);
+    for (gidx r = b[0]; r <= b[1]; r++)
+    {
+        for (gidx c = b[2]; c <= b[3]; c++)
+        {
+            auto const it = cells.find({ r, c });
+            char const expected = it == cells.end() ? Grid::EMPTY_CHAR : it->second.first;
+            check(grid.get_cell_content(r - b[0], c - b[2]) == expected, "cell content", context);
+        }
+    }
+
+    for (auto const &[loc, id] : model.placed)
+    {
+        std::int_fast32_t crossings = 0;
+        for (gidx i = 0; i < model.words.length(id); i++)
+        {
+            crossings += cells.at(Model::cell_of(loc, i)).second > 1;
+        }
+        check(grid.get_word_crossing_count(loc) == crossings, "crossings of a word", context);
+    }
+
+    // a grid with the same words built from scratch, through a snapshot
+    Grid rebuilt(model.words, grid.get_max_height(), grid.get_max_width());
+    snapshot::restore(snapshot::capture(grid, 0), rebuilt);
+    check(rebuilt.get_hash() == grid.get_hash(), "hash", context);
+
+    // placement rules, for a few words over the whole internal grid
+    for (int sample = 0; sample < 3; sample++)
+    {
+        wid const id = std::uniform_int_distribution<wid>(0, model.words.size() - 1)(rng);
+        std::vector<Location> found;
+        grid.get_valid_placements(id, found);
+        std::set<Location> const reported(found.begin(), found.end());
+        std::set<Location> expected;
+        for (gidx r = -1; r <= 2 * model.max_rows; r++)
+        {
+            for (gidx c = -1; c <= 2 * model.max_columns; c++)
+            {
+                for (Direction const dir : { Direction::VERTICAL, Direction::HORIZONTAL })
+                {
+                    Location const loc = { r, c, dir };
+                    bool const valid = model.is_valid_placement(id, loc);
+                    if (r >= 0 && c >= 0 && r < 2 * model.max_rows && c < 2 * model.max_columns)
+                        check(grid.is_valid_placement(id, loc) == valid, "valid placement", context);
+                    bool crosses = false;
+                    for (gidx i = 0; i < model.words.length(id); i++)
+                    {
+                        crosses |= cells.count(Model::cell_of(loc, i)) != 0;
+                    }
+                    if (valid && crosses)
+                        expected.insert(loc);
+                }
+            }
+        }
+        check(reported == expected, "valid placements", context);
+    }
+
+    LayoutMetrics metrics;
+    grid.get_layout_metrics(metrics);
+    check(metrics.letter_count == static_cast<std::int_fast32_t>(cells.size()), "layout letter count", context);
+    check(metrics.area == grid.get_height() * grid.get_width(), "layout area", context);
+}
+
+// random words over a small alphabet, so that they cross a lot
+std::string write_word_list(std::default_random_engine &rng)
+{
+    std::filesystem::path const location = std::filesystem::temp_directory_path() / "gridtest_words.csv";
+    std::ofstream out(location);
+    out << "Clue,Solution" << std::endl;
+    for (int i = 0; i < 60; i++)
+    {
+        std::string word;
+        for (int length = std::uniform_int_distribution<int>(2, 9)(rng); length > 0; length--)
+        {
+            word += "ABCDE"[std::uniform_int_distribution<int>(0, 4)(rng)];
+        }
+        out << "Clue " << i << "," << word << std::endl;
+    }
+    return location.string();
+}
+
+} // namespace
+
+int main()
+{
+    std::default_random_engine rng(1);
+    WordStore words;
+    CSVWordProvider(write_word_list(rng)).retrieve_word_list(words);
+
+    // fixed dimensions, see Grid::select_kernels(), and runtime ones
+    std::vector<std::pair<gidx, gidx> > const dimensions = { { 15, 15 }, { 21, 21 }, { 9, 13 }, { 12, 7 } };
+    for (auto const &[rows, columns] : dimensions)
+    {
+        for (int seed = 0; seed < 8; seed++)
+        {
+            rng.seed(seed);
+            Grid grid(words, rows, columns);
+            Model model(words, rows, columns);
+            for (int step = 0; step < 120 && failures == 0; step++)
+            {
+                std::ostringstream context;
+                context << rows << "x" << columns << ", seed " << seed << ", step " << step;
+                int const action = std::uniform_int_distribution<int>(0, 9)(rng);
+                if (model.placed.empty() || action == 9)
+                {
+                    grid.reset();
+                    model.placed.clear();
+                    wid const id = std::uniform_int_distribution<wid>(0, words.size() - 1)(rng);
+                    Direction const dir = action % 2 ? Direction::HORIZONTAL : Direction::VERTICAL;
+                    if (!grid.place_first_word(id, dir))
+                        continue;
+                    std::vector<Location> locations;
+                    grid.get_placed_locations(locations);
+                    model.placed[locations.front()] = id;
+                }
+                else if (action < 6)
+                {
+                    wid const id = std::uniform_int_distribution<wid>(0, words.size() - 1)(rng);
+                    std::vector<Location> found;
+                    grid.get_valid_placements(id, found);
+                    if (found.empty())
+                        continue;
+                    Location const loc = found[std::uniform_int_distribution<std::size_t>(0, found.size() - 1)(rng)];
+                    grid.place_word_unchecked(id, loc);
+                    model.placed[loc] = id;
+                }
+                else if (action < 7)
+                {
+                    std::vector<Location> locations;
+                    grid.get_placed_locations(locations);
+                    grid.remove_last_word();
+                    model.placed.erase(locations.back());
+                }
+                else
+                {
+                    // any word, whatever it crosses
+                    auto it = model.placed.begin();
+                    std::advance(it, std::uniform_int_distribution<std::size_t>(0, model.placed.size() - 1)(rng));
+                    check(grid.remove_word(it->first), "remove word", context.str());
+                    model.placed.erase(it);
+                }
+                compare(grid, model, rng, context.str());
+            }
+        }
+    }
+
+    if (failures > 0)
+    {
+        std::cerr << failures << " grid checks failed" << std::endl;
+        return 1;
+    }
+    std::cout << "Grid consistent with the reference model" << std::endl;
+    return 0;
+}
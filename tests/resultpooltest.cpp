@@ -0,0 +1,134 @@
+/**
+    Test of snapshot::ResultPool against a reference model that keeps its
+    grids in a list and compares every pair of grids word by word. Random
+    grids over a few words and locations, so that many of them are similar,
+    are added to pools of several capacities and minimum differences, and
+    after every add the pool's grids and threshold are compared with the
+    model's, and the kept grids are checked to differ pairwise. The runs
+    stop once a check failed, and the test exits with 1 at the end if any
+    check failed.
+ */
+#include <algorithm>
+#include <cstdint>
+#include <iostream>
+#include <limits>
+#include <random>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include "check.h"
+#include "resultpool.h"
+
+using namespace snapshot;
+
+namespace
+{
+
+// number of words of either grid that the other one does not have at the same place
+std::int_fast32_t difference(GridSnapshot const &lhs, GridSnapshot const &rhs)
+{
+    auto const key = [](GridSnapshot::PlacedWord const &placed) {
+        return std::make_tuple(placed.word, placed.loc.row, placed.loc.column, placed.loc.direction);
+    };
+    std::vector<GridSnapshot::PlacedWord> unmatched = rhs.words;
+    std::int_fast32_t shared = 0;
+    for (auto const &placed : lhs.words)
+    {
+        auto const match = std::find_if(unmatched.begin(), unmatched.end(),
+                                        [&](GridSnapshot::PlacedWord const &other) { return key(other) == key(placed); });
+        if (match != unmatched.end())
+        {
+            shared++;
+            unmatched.erase(match);
+        }
+    }
+    return lhs.words.size() + rhs.words.size() - 2 * shared;
+}
+
+class Model
+{
+public:
+    std::size_t capacity;
+    std::int_fast32_t min_difference;
+    // the kept grids, best first; of equal scores, the one added first
+    std::vector<GridSnapshot> grids;
+
+    bool add(GridSnapshot const &snapshot)
+    {
+        if (capacity == 0 || (grids.size() == capacity && snapshot.grid_score <= grids.back().grid_score))
+            return false;
+        for (auto const &kept : grids)
+        {
+            if (difference(kept, snapshot) < min_difference && kept.grid_score >= snapshot.grid_score)
+                return false;
+        }
+        grids.erase(std::remove_if(grids.begin(), grids.end(),
+                                   [&](GridSnapshot const &kept) { return difference(kept, snapshot) < min_difference; }),
+                    grids.end());
+        auto const position = std::find_if(grids.begin(), grids.end(),
+                                           [&](GridSnapshot const &kept) { return kept.grid_score < snapshot.grid_score; });
+        grids.insert(position, snapshot);
+        if (grids.size() > capacity)
+            grids.pop_back();
+        return true;
+    }
+};
+
+} // namespace
+
+int main()
+{
+    std::default_random_engine rng(1);
+    for (int run = 0; run < 200 && failures == 0; run++)
+    {
+        std::size_t const capacity = std::uniform_int_distribution<std::size_t>(0, 12)(rng);
+        std::int_fast32_t const min_difference = std::uniform_int_distribution<std::int_fast32_t>(1, 6)(rng);
+        ResultPool pool(capacity, min_difference);
+        Model model = { capacity, min_difference, {} };
+
+        for (int i = 0; i < 300 && failures == 0; i++)
+        {
+            std::string const context = "capacity " + std::to_string(capacity) + ", min_difference "
+                                        + std::to_string(min_difference) + ", run " + std::to_string(run)
+                                        + ", grid " + std::to_string(i);
+            GridSnapshot snapshot = { std::uniform_int_distribution<scoring::score>(0, 50)(rng),
+                                      static_cast<std::uint64_t>(i), 10, 10, {} };
+            for (int words = std::uniform_int_distribution<int>(3, 8)(rng); words > 0; words--)
+            {
+                snapshot.words.push_back({ std::uniform_int_distribution<wid>(0, 5)(rng),
+                                           { std::uniform_int_distribution<grid::gidx>(0, 2)(rng),
+                                             std::uniform_int_distribution<grid::gidx>(0, 2)(rng),
+                                             static_cast<grid::Direction>(std::uniform_int_distribution<int>(0, 1)(rng)) } });
+            }
+
+            check(pool.add(snapshot) == model.add(snapshot), "add", context);
+            std::vector<GridSnapshot> const kept = pool.best_first();
+            check(pool.size() == kept.size() && kept.size() == model.grids.size(), "size", context);
+            scoring::score const threshold = model.grids.size() < capacity ? std::numeric_limits<scoring::score>::min()
+                                             : capacity > 0 ? model.grids.back().grid_score
+                                             : std::numeric_limits<scoring::score>::max();
+            check(pool.get_threshold() == threshold, "threshold", context);
+            for (std::size_t k = 0; k < kept.size() && k < model.grids.size(); k++)
+            {
+                // the hashes are the order in which the grids were added
+                check(kept[k].hash == model.grids[k].hash, "kept grids", context);
+            }
+            for (std::size_t a = 0; a < kept.size(); a++)
+            {
+                for (std::size_t b = a + 1; b < kept.size(); b++)
+                {
+                    check(difference(kept[a], kept[b]) >= min_difference, "kept grids differ", context);
+                }
+            }
+        }
+    }
+
+    if (failures > 0)
+    {
+        std::cerr << failures << " result pool checks failed" << std::endl;
+        return 1;
+    }
+    std::cout << "Result pools consistent with the reference model" << std::endl;
+    return 0;
+}
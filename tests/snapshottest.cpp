@@ -0,0 +1,186 @@
+/**
+    Test of grid snapshots and pool files: restored grids must equal the
+    captured ones, a pool file must only hold the latest checkpoint, and
+    damaged pool files or snapshots must be rejected before any word is
+    placed out of its grid. Every failed check is reported, and the test
+    exits with 1 at the end if any check failed.
+ */
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "check.h"
+#include "csvwordprovider.h"
+#include "grid.h"
+#include "snapshot.h"
+
+using namespace grid;
+
+namespace
+{
+
+constexpr gidx ROWS = 15, COLUMNS = 15;
+// position of the first placed word of the first grid record, see snapshot.cpp
+constexpr std::size_t FIRST_WORD_POSITION = 32 + 8 + 32;
+
+std::string write_word_list()
+{
+    std::filesystem::path const location = std::filesystem::temp_directory_path() / "snapshottest_words.csv";
+    std::ofstream out(location);
+    out << "Clue,Solution" << std::endl;
+    std::default_random_engine rng(1);
+    for (int i = 0; i < 60; i++)
+    {
+        std::string word;
+        for (int length = std::uniform_int_distribution<int>(3, 8)(rng); length > 0; length--)
+        {
+            word += "ABCDE"[std::uniform_int_distribution<int>(0, 4)(rng)];
+        }
+        out << "Clue " << i << "," << word << std::endl;
+    }
+    return location.string();
+}
+
+snapshot::GridSnapshot random_grid(WordStore const &words, std::default_random_engine &rng)
+{
+    Grid grid(words, ROWS, COLUMNS);
+    grid.place_first_word(0, Direction::HORIZONTAL);
+    for (int i = 0; i < 40; i++)
+    {
+        wid const id = std::uniform_int_distribution<wid>(0, words.size() - 1)(rng);
+        std::vector<Location> found;
+        grid.get_valid_placements(id, found);
+        if (!found.empty())
+        {
+            grid.place_word_unchecked(id, found[std::uniform_int_distribution<std::size_t>(0, found.size() - 1)(rng)]);
+        }
+    }
+    return snapshot::capture(grid, grid.get_placed_word_count());
+}
+
+bool restores(snapshot::GridSnapshot const &saved, WordStore const &words)
+{
+    Grid grid(words, ROWS, COLUMNS);
+    try
+    {
+        snapshot::restore(saved, grid);
+    }
+    catch (std::runtime_error const &)
+    {
+        return false;
+    }
+    return true;
+}
+
+bool reads(std::filesystem::path const &location, std::vector<char> const &contents, WordStore const &words)
+{
+    {
+        std::ofstream out(location, std::ios::binary | std::ios::trunc);
+        out.write(contents.data(), contents.size());
+    }
+    try
+    {
+        snapshot::read_last_checkpoint(location.string(), words, ROWS, COLUMNS);
+    }
+    catch (std::runtime_error const &)
+    {
+        return false;
+    }
+    return true;
+}
+
+} // namespace
+
+int main()
+{
+    WordStore words;
+    CSVWordProvider(write_word_list()).retrieve_word_list(words);
+    std::default_random_engine rng(1);
+    std::filesystem::path const location = std::filesystem::temp_directory_path() / "snapshottest.pool";
+    std::filesystem::remove(location);
+
+    snapshot::Checkpoint checkpoint = { 7, 0, { "state 0", "state 1" }, {} };
+    for (int i = 0; i < 5; i++)
+    {
+        checkpoint.pool.push_back(random_grid(words, rng));
+    }
+
+    // every checkpoint replaces the previous one
+    snapshot::PoolWriter writer(location.string(), words, ROWS, COLUMNS);
+    std::uintmax_t first_size = 0;
+    for (int restarts = 100; restarts <= 500; restarts += 100)
+    {
+        checkpoint.finished_restarts = restarts;
+        writer.write(checkpoint);
+        if (first_size == 0)
+            first_size = std::filesystem::file_size(location);
+    }
+    check(std::filesystem::file_size(location) == first_size, "pool file holds only the latest checkpoint");
+    check(!std::filesystem::exists(location.string() + ".tmp"), "temporary pool file removed");
+
+    snapshot::Checkpoint const read = snapshot::read_last_checkpoint(location.string(), words, ROWS, COLUMNS);
+    check(read.rng_seed == 7 && read.finished_restarts == 500 && read.rng_states == checkpoint.rng_states,
+          "checkpoint read back");
+    check(read.pool.size() == checkpoint.pool.size(), "pool read back");
+    for (std::size_t i = 0; i < read.pool.size() && i < checkpoint.pool.size(); i++)
+    {
+        Grid grid(words, ROWS, COLUMNS);
+        snapshot::restore(read.pool[i], grid);
+        check(grid.get_hash() == checkpoint.pool[i].hash
+              && grid.get_placed_word_count() == static_cast<std::int_fast32_t>(checkpoint.pool[i].words.size()),
+              "grid restored");
+    }
+
+    // damaged placed words of the first grid
+    std::vector<char> file;
+    {
+        std::ifstream in(location, std::ios::binary);
+        file.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    }
+    check(reads(location, file, words), "intact pool file read");
+    std::vector<char> damaged = file;
+    damaged[FIRST_WORD_POSITION + 8] = 2;
+    check(!reads(location, damaged, words), "unknown direction rejected");
+    damaged = file;
+    std::uint32_t const unknown_word = words.size();
+    std::memcpy(&damaged[FIRST_WORD_POSITION], &unknown_word, sizeof(unknown_word));
+    check(!reads(location, damaged, words), "unknown word rejected");
+    damaged = file;
+    // the first word is horizontal and at least 3 letters long
+    std::uint16_t const column = COLUMNS - 1;
+    std::memcpy(&damaged[FIRST_WORD_POSITION + 6], &column, sizeof(column));
+    check(!reads(location, damaged, words), "word out of the grid rejected");
+
+    // snapshots whose words or hash were changed
+    snapshot::GridSnapshot saved = checkpoint.pool.front();
+    check(restores(saved, words), "intact snapshot restored");
+    saved.hash++;
+    check(!restores(saved, words), "wrong hash rejected");
+    saved = checkpoint.pool.front();
+    for (wid id = 0; id < words.size(); id++)
+    {
+        if (words.length(id) == words.length(saved.words.back().word)
+            && words.letters(id) != words.letters(saved.words.back().word))
+        {
+            saved.words.back().word = id;
+            break;
+        }
+    }
+    check(!restores(saved, words), "changed word rejected");
+
+    std::filesystem::remove(location);
+    if (failures > 0)
+    {
+        std::cerr << failures << " snapshot checks failed" << std::endl;
+        return 1;
+    }
+    std::cout << "Snapshots and pool files checked" << std::endl;
+    return 0;
+}
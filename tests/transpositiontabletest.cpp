@@ -0,0 +1,128 @@
+/**
+    Test of search::TranspositionTable against a reference model that keeps
+    the most recent hashes of every bucket in a list. Random inserts, finds
+    and clears are applied to tables of several sizes, and every result is
+    compared with the model's. The steps stop once a check failed, and the
+    test exits with 1 at the end if any check failed.
+ */
+#include <cstdint>
+#include <deque>
+#include <iostream>
+#include <map>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "check.h"
+#include "transpositiontable.h"
+
+namespace
+{
+
+// see TranspositionTable
+constexpr std::size_t BUCKET_SIZE = 4;
+
+class Model
+{
+public:
+    std::uint64_t bucket_mask;
+    // the hashes of every bucket with their scores, the most recent first
+    std::map<std::uint64_t, std::deque<std::pair<std::uint64_t, scoring::score> > > buckets;
+
+    explicit Model(std::size_t size)
+    {
+        std::size_t bucket_count = 1;
+        while (bucket_count * BUCKET_SIZE < size)
+        {
+            bucket_count *= 2;
+        }
+        bucket_mask = bucket_count - 1;
+    }
+
+    // the empty grid hashes to 0, which the table stores as 1
+    static std::uint64_t stored(std::uint64_t hash)
+    {
+        return hash == 0 ? 1 : hash;
+    }
+
+    std::deque<std::pair<std::uint64_t, scoring::score> > &bucket(std::uint64_t hash)
+    {
+        return buckets[(stored(hash) >> 32) & bucket_mask];
+    }
+
+    scoring::score const *find(std::uint64_t hash)
+    {
+        for (auto const &entry : bucket(hash))
+        {
+            if (entry.first == stored(hash))
+                return &entry.second;
+        }
+        return nullptr;
+    }
+
+    bool insert(std::uint64_t hash, scoring::score grid_score)
+    {
+        if (find(hash) != nullptr)
+            return false;
+        auto &entries = bucket(hash);
+        entries.push_front({ stored(hash), grid_score });
+        if (entries.size() > BUCKET_SIZE)
+            entries.pop_back();
+        return true;
+    }
+};
+
+} // namespace
+
+int main()
+{
+    std::default_random_engine rng(1);
+    for (std::size_t size : { 1, 4, 5, 64, 1000 })
+    {
+        search::TranspositionTable table(size);
+        Model model(size);
+        // few distinct hashes, so that they are found again, and share buckets
+        std::vector<std::uint64_t> hashes = { 0, 1 };
+        for (int i = 0; i < 200; i++)
+        {
+            hashes.push_back(static_cast<std::uint64_t>(rng()) << 32 | rng());
+        }
+
+        for (int step = 0; step < 20000 && failures == 0; step++)
+        {
+            std::string const context = "size " + std::to_string(size) + ", step " + std::to_string(step);
+            std::uint64_t const hash = hashes[std::uniform_int_distribution<std::size_t>(0, hashes.size() - 1)(rng)];
+            int const action = std::uniform_int_distribution<int>(0, 999)(rng);
+            if (action == 0)
+            {
+                table.clear();
+                model.buckets.clear();
+            }
+            else if (action < 500)
+            {
+                scoring::score const grid_score = std::uniform_int_distribution<scoring::score>(-1000, 1000)(rng);
+                check(table.insert(hash, grid_score) == model.insert(hash, grid_score), "insert", context);
+            }
+            else
+            {
+                scoring::score const *found = table.find(hash);
+                scoring::score const *expected = model.find(hash);
+                check((found == nullptr) == (expected == nullptr), "find", context);
+                check(found == nullptr || expected == nullptr || *found == *expected, "score", context);
+            }
+        }
+    }
+
+    // a table of size 0 records nothing
+    search::TranspositionTable disabled(0);
+    check(disabled.insert(42, 1) && disabled.insert(42, 1) && disabled.find(42) == nullptr, "disabled table",
+          "size 0");
+
+    if (failures > 0)
+    {
+        std::cerr << failures << " transposition table checks failed" << std::endl;
+        return 1;
+    }
+    std::cout << "Transposition tables consistent with the reference model" << std::endl;
+    return 0;
+}